@@ -1,7 +1,9 @@
 #include "benchmark/query_experiment.hpp"
 #include "benchmark/option_parser.hpp"
+#include "benchmark/cache_miss_experiment.hpp"
 
 #include "cas/cas.hpp"
+#include "cas/node_dispatch.hpp"
 #include "cas/cas_seq.hpp"
 
 #include <benchmark/insertion_experiment.hpp>
@@ -22,15 +24,9 @@ cas::SearchKey<VType> Query(std::string path, VType low, VType high) {
 }
 
 
-void Benchmark(const benchmark::Config& config) {
+std::vector<cas::SearchKey<cas::vint64_t>> Queries() {
   using VType = cas::vint64_t;
-  using Exp = benchmark::InsertionQueryExperiment2<VType>;
-
-  std::vector<cas::InsertMethod> insert_methods = {
-    config.insert_method_,
-  };
-
-  std::vector<cas::SearchKey<VType>> queries = {
+  return {
     Query<VType>("/usr/include^", 5000, cas::VINT64_MAX),
     Query<VType>("/usr/include^", 3000, 4000),
     Query<VType>("/usr/lib^", 0, 1000),
@@ -38,6 +34,34 @@ void Benchmark(const benchmark::Config& config) {
     Query<VType>("/usr/share/doc^README", 4000, 5000),
     Query<VType>("/etc^", 5000, cas::VINT64_MAX),
   };
+}
+
+
+// misses per visited node without and with prefetching
+void BenchmarkCacheMisses(const benchmark::Config& config) {
+  using VType = cas::vint64_t;
+  std::vector<size_t> prefetch_distances = {
+    0, static_cast<size_t>(config.prefetch_distance_),
+  };
+  benchmark::CacheMissExperiment<VType> bm(
+    config.input_filename_,
+    config.dataset_delim_,
+    Queries(),
+    prefetch_distances
+  );
+  bm.Run();
+}
+
+
+void Benchmark(const benchmark::Config& config) {
+  using VType = cas::vint64_t;
+  using Exp = benchmark::InsertionQueryExperiment2<VType>;
+
+  std::vector<cas::InsertMethod> insert_methods = {
+    config.insert_method_,
+  };
+
+  std::vector<cas::SearchKey<VType>> queries = Queries();
 
   Exp bm(
     config.input_filename_,
@@ -54,6 +78,13 @@ void Benchmark(const benchmark::Config& config) {
 
 int main(int argc, char** argv) {
   benchmark::Config config = benchmark::option_parser::Parse(argc, argv);
-  Benchmark(config);
+  std::cout << "node dispatch: " << cas::NodeDispatch::Name() << std::endl;
+  std::cout << "child refs: " << cas::ChildRefName() << std::endl;
+  std::cout << "node alignment: " << cas::NodeAllocator::kInnerNodeAlign << std::endl;
+  if (config.count_cache_misses_) {
+    BenchmarkCacheMisses(config);
+  } else {
+    Benchmark(config);
+  }
   return 0;
 }
@@ -2,6 +2,7 @@
 #include "benchmark/option_parser.hpp"
 
 #include "cas/cas.hpp"
+#include "cas/node_dispatch.hpp"
 #include "cas/cas_seq.hpp"
 
 #include <benchmark/insertion_experiment2.hpp>
@@ -29,6 +30,8 @@ void Benchmark(const benchmark::Config& config) {
 
 int main(int argc, char** argv) {
   benchmark::Config config = benchmark::option_parser::Parse(argc, argv);
+  std::cout << "node dispatch: " << cas::NodeDispatch::Name() << std::endl;
+  std::cout << "child refs: " << cas::ChildRefName() << std::endl;
   Benchmark(config);
   return 0;
 }
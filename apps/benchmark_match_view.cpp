@@ -0,0 +1,85 @@
+#include "cas/cas.hpp"
+#include "cas/key.hpp"
+#include "cas/match_view.hpp"
+#include "cas/search_key.hpp"
+#include "benchmark/allocation_counter.hpp"
+
+#include <deque>
+#include <iostream>
+#include <string>
+
+
+using VType = cas::vint64_t;
+
+
+std::deque<cas::Key<VType>> GenerateKeys(size_t nr_keys) {
+  std::deque<cas::Key<VType>> keys;
+  for (size_t i = 0; i < nr_keys; ++i) {
+    cas::Key<VType> key;
+    key.path_ = { "usr", "share", "lib" + std::to_string(i % 100),
+      "module" + std::to_string(i % 37), "file" + std::to_string(i % 1000) };
+    key.value_ = static_cast<VType>(i);
+    key.did_ = i;
+    keys.push_back(key);
+  }
+  return keys;
+}
+
+
+cas::SearchKey<VType> Query(std::string path, VType low, VType high) {
+  cas::SearchKey<VType> skey;
+  skey.path_ = { path };
+  skey.low_  = low;
+  skey.high_ = high;
+  return skey;
+}
+
+
+void Benchmark(size_t nr_keys, size_t nr_repetitions) {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  auto keys = GenerateKeys(nr_keys);
+  index.BulkLoad(keys);
+
+  // queries that match a large fraction of the keys, so that decoding
+  // dominates the runtime
+  std::vector<cas::SearchKey<VType>> queries = {
+    Query("/usr^", cas::VINT64_MIN, cas::VINT64_MAX),
+    Query("/usr/share^", 0, static_cast<VType>(nr_keys / 2)),
+    Query("/usr/share/?/?/file7", cas::VINT64_MIN, cas::VINT64_MAX),
+  };
+
+  // both consumers read the value and the last label of every match
+  size_t checksum = 0;
+  benchmark::Measure("full decode", "match", nr_repetitions, [&](size_t) {
+    size_t nr_matches = 0;
+    for (auto& skey : queries) {
+      index.Query(skey, [&](const cas::Key<VType>& key) {
+        checksum += key.value_ + key.path_.back().size();
+        ++nr_matches;
+      });
+    }
+    return nr_matches;
+  });
+
+  benchmark::Measure("match view", "match", nr_repetitions, [&](size_t) {
+    size_t nr_matches = 0;
+    for (auto& skey : queries) {
+      index.Query(skey, [&](const cas::MatchView<VType>& match) {
+        checksum += match.Value() + match.LastLabel().size();
+        ++nr_matches;
+      });
+    }
+    return nr_matches;
+  });
+  std::cout << "checksum: " << checksum << std::endl;
+}
+
+
+int main(int argc, char** argv) {
+  size_t nr_keys = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  size_t nr_repetitions = argc > 2 ? std::stoul(argv[2]) : 10;
+  std::cout << "nr_keys: " << nr_keys << std::endl;
+  std::cout << "nr_repetitions: " << nr_repetitions << std::endl;
+  Benchmark(nr_keys, nr_repetitions);
+  return 0;
+}
@@ -2,6 +2,8 @@
 #include "benchmark/option_parser.hpp"
 
 #include "cas/cas.hpp"
+#include "cas/node_dispatch.hpp"
+#include "cas/key_search.hpp"
 #include "cas/cas_seq.hpp"
 
 #include <benchmark/merge_query_experiment.hpp>
@@ -51,6 +53,9 @@ void Benchmark(const benchmark::Config& config) {
 
 int main(int argc, char** argv) {
   benchmark::Config config = benchmark::option_parser::Parse(argc, argv);
+  std::cout << "node dispatch: " << cas::NodeDispatch::Name() << std::endl;
+  std::cout << "child refs: " << cas::ChildRefName() << std::endl;
+  std::cout << "key search: " << cas::KeySearch::Name() << std::endl;
   Benchmark(config);
   return 0;
 }
@@ -0,0 +1,76 @@
+#include "cas/cas.hpp"
+#include "cas/key.hpp"
+#include "cas/query_context.hpp"
+#include "cas/search_key.hpp"
+#include "benchmark/allocation_counter.hpp"
+
+#include <deque>
+#include <iostream>
+#include <string>
+
+
+using VType = cas::vint64_t;
+
+
+std::deque<cas::Key<VType>> GenerateKeys(size_t nr_keys) {
+  std::deque<cas::Key<VType>> keys;
+  for (size_t i = 0; i < nr_keys; ++i) {
+    cas::Key<VType> key;
+    key.path_ = { "usr", "lib" + std::to_string(i % 100),
+      "file" + std::to_string(i % 1000) };
+    key.value_ = static_cast<VType>(i);
+    key.did_ = i;
+    keys.push_back(key);
+  }
+  return keys;
+}
+
+
+cas::SearchKey<VType> PointQuery(size_t i) {
+  cas::SearchKey<VType> skey;
+  skey.path_ = { "/usr/lib" + std::to_string(i % 100) +
+    "/file" + std::to_string(i % 1000) };
+  skey.low_  = static_cast<VType>(i);
+  skey.high_ = static_cast<VType>(i);
+  return skey;
+}
+
+
+void Benchmark(size_t nr_keys, size_t nr_queries) {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  auto keys = GenerateKeys(nr_keys);
+  index.BulkLoad(keys);
+
+  // the search keys are built up front so that only the queries are measured
+  std::vector<cas::SearchKey<VType>> queries;
+  for (size_t i = 0; i < nr_queries; ++i) {
+    queries.push_back(PointQuery(i % nr_keys));
+  }
+
+  // warm up the context of this thread
+  if (!queries.empty()) {
+    index.QueryRuntime(queries[0]);
+  }
+
+  benchmark::Measure("fresh context", "query", nr_queries, [&](size_t i) {
+    cas::QueryContext context;
+    index.Query(queries[i], [](const std::vector<uint8_t>&,
+          const std::vector<uint8_t>&, cas::did_t) {}, context);
+    return 1;
+  });
+
+  benchmark::Measure("thread context", "query", nr_queries, [&](size_t i) {
+    index.QueryRuntime(queries[i]);
+    return 1;
+  });
+}
+
+
+int main(int argc, char** argv) {
+  size_t nr_keys = argc > 1 ? std::stoul(argv[1]) : 100000;
+  size_t nr_queries = argc > 2 ? std::stoul(argv[2]) : 100000;
+  std::cout << "nr_keys: " << nr_keys << std::endl;
+  std::cout << "nr_queries: " << nr_queries << std::endl;
+  Benchmark(nr_keys, nr_queries);
+  return 0;
+}
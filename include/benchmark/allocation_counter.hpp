@@ -0,0 +1,52 @@
+#ifndef BENCHMARK_ALLOCATION_COUNTER_HPP_
+#define BENCHMARK_ALLOCATION_COUNTER_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+
+namespace benchmark {
+
+
+/**
+ * Number of heap allocations of the whole process so far, counted by
+ * the global operator new that allocation_counter.cpp replaces. Only
+ * programs that link allocation_counter.cpp may call it.
+ **/
+size_t NrAllocations();
+
+
+/**
+ * Calls run(i) for i in [0, nr_runs) and prints the heap allocations
+ * and nanoseconds per unit, where run returns the number of units
+ * (e.g., queries or matches) it processed
+ **/
+template<class Fn>
+void Measure(const std::string& name, const std::string& unit,
+    size_t nr_runs, Fn&& run) {
+  size_t allocations_before = NrAllocations();
+  size_t nr_units = 0;
+  const auto& t_start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < nr_runs; ++i) {
+    nr_units += run(i);
+  }
+  const auto& t_end = std::chrono::high_resolution_clock::now();
+  size_t allocations = NrAllocations() - allocations_before;
+  double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      t_end - t_start).count();
+  if (nr_units == 0) {
+    std::cout << name << ": no " << unit << " measured" << std::endl;
+    return;
+  }
+  std::cout << name
+    << ": allocations/" << unit << "=" << (allocations / static_cast<double>(nr_units))
+    << ", ns/" << unit << "=" << (ns / nr_units) << std::endl;
+}
+
+
+} // namespace benchmark
+
+
+#endif // BENCHMARK_ALLOCATION_COUNTER_HPP_
@@ -0,0 +1,105 @@
+#ifndef BENCHMARK_CACHE_MISS_COUNTER_HPP_
+#define BENCHMARK_CACHE_MISS_COUNTER_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+namespace benchmark {
+
+
+/**
+ * Counts the L1 data cache and last level cache read misses of the
+ * calling thread between Start and Stop with the perf_event_open
+ * system call. Available returns false if the kernel refuses to open
+ * the counters (e.g., in containers or with a restrictive
+ * perf_event_paranoid setting).
+ **/
+class CacheMissCounter {
+  int fd_l1_ = -1;
+  int fd_llc_ = -1;
+
+public:
+  CacheMissCounter() {
+    fd_l1_  = Open(PERF_COUNT_HW_CACHE_L1D);
+    fd_llc_ = Open(PERF_COUNT_HW_CACHE_LL);
+  }
+
+  ~CacheMissCounter() {
+    if (fd_l1_ != -1) {
+      close(fd_l1_);
+    }
+    if (fd_llc_ != -1) {
+      close(fd_llc_);
+    }
+  }
+
+  CacheMissCounter(const CacheMissCounter&) = delete;
+  CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+  bool Available() const {
+    return fd_l1_ != -1 && fd_llc_ != -1;
+  }
+
+  void Start() {
+    Enable(fd_l1_);
+    Enable(fd_llc_);
+  }
+
+  void Stop() {
+    Disable(fd_l1_);
+    Disable(fd_llc_);
+  }
+
+  uint64_t L1Misses() const {
+    return Read(fd_l1_);
+  }
+
+  uint64_t LlcMisses() const {
+    return Read(fd_llc_);
+  }
+
+private:
+  static int Open(uint64_t cache) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = cache |
+      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  static void Enable(int fd) {
+    if (fd != -1) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  static void Disable(int fd) {
+    if (fd != -1) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+
+  static uint64_t Read(int fd) {
+    uint64_t count = 0;
+    if (fd == -1 || read(fd, &count, sizeof(count)) != sizeof(count)) {
+      return 0;
+    }
+    return count;
+  }
+};
+
+}; // namespace benchmark
+
+#endif // BENCHMARK_CACHE_MISS_COUNTER_HPP_
@@ -0,0 +1,53 @@
+#ifndef BENCHMARK_CACHE_MISS_EXPERIMENT_H_
+#define BENCHMARK_CACHE_MISS_EXPERIMENT_H_
+
+#include "cas/search_key.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace benchmark {
+
+
+/**
+ * Bulk-loads a dataset and executes the queries with every prefetch
+ * distance (0 disables prefetching). Reports the L1 and LLC read
+ * misses per visited node and the runtime of the queries.
+ **/
+template<class VType>
+class CacheMissExperiment {
+private:
+  struct Result {
+    size_t prefetch_distance_;
+    uint64_t read_nodes_ = 0;
+    uint64_t l1_misses_ = 0;
+    uint64_t llc_misses_ = 0;
+    uint64_t runtime_mus_ = 0;
+  };
+
+  const std::string dataset_filename_;
+  const char dataset_delim_;
+  std::vector<cas::SearchKey<VType>> queries_;
+  std::vector<size_t> prefetch_distances_;
+  std::vector<Result> results_;
+  bool counters_available_ = false;
+
+public:
+  CacheMissExperiment(
+      const std::string dataset_filename,
+      const char dataset_delim,
+      std::vector<cas::SearchKey<VType>> queries,
+      std::vector<size_t> prefetch_distances
+  );
+
+  void Run();
+
+  void PrintOutput();
+};
+
+
+}; // namespace benchmark
+
+
+#endif // BENCHMARK_CACHE_MISS_EXPERIMENT_H_
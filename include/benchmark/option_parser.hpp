@@ -16,6 +16,8 @@ struct Config {
   cas::InsertMethod insert_method_ = cas::MainLF;
   cas::MergeMethod merge_method_ = cas::MergeMethod::Fast;
   std::string perf_datafile_ = "perf.data";
+  bool count_cache_misses_ = false;
+  int prefetch_distance_ = 4;
 };
 
 
@@ -57,6 +59,8 @@ void Parse(int argc, char** argv, benchmark::Config& config) {
   const int OPT_INSERT_METHOD = 4;
   const int OPT_MERGE_METHOD = 5;
   const int OPT_PERF_DATAFILE = 6;
+  const int OPT_CACHE_MISSES = 7;
+  const int OPT_PREFETCH_DISTANCE = 8;
   static struct option long_options[] = {
     {"input_filename",    required_argument, nullptr, OPT_INPUT_FILENAME},
     {"bulkload_percent",  required_argument, nullptr, OPT_BULKLOAD_PERCENT},
@@ -64,6 +68,8 @@ void Parse(int argc, char** argv, benchmark::Config& config) {
     {"insert_method",     required_argument, nullptr, OPT_INSERT_METHOD},
     {"merge_method",      required_argument, nullptr, OPT_MERGE_METHOD},
     {"perf_datafile",     required_argument, nullptr, OPT_PERF_DATAFILE},
+    {"cache_misses",      required_argument, nullptr, OPT_CACHE_MISSES},
+    {"prefetch_distance", required_argument, nullptr, OPT_PREFETCH_DISTANCE},
     {0, 0, 0, 0}
   };
 
@@ -105,6 +111,18 @@ void Parse(int argc, char** argv, benchmark::Config& config) {
       case OPT_PERF_DATAFILE:
         config.perf_datafile_ = optvalue;
         break;
+      case OPT_CACHE_MISSES:
+        int cache_misses;
+        ParseInt(optarg, cache_misses, long_options[option_index].name);
+        config.count_cache_misses_ = cache_misses != 0;
+        break;
+      case OPT_PREFETCH_DISTANCE:
+        ParseInt(optarg, config.prefetch_distance_, long_options[option_index].name);
+        if (config.prefetch_distance_ < 0) {
+          std::cerr << "--prefetch_distance must not be negative";
+          exit(-1);
+        }
+        break;
     }
   }
 }
@@ -0,0 +1,108 @@
+#ifndef CAS_BATCH_QUERY_H_
+#define CAS_BATCH_QUERY_H_
+
+#include "cas/node.hpp"
+#include "cas/path_matcher.hpp"
+#include "cas/query_stats.hpp"
+#include "cas/search_key.hpp"
+#include "cas/index.hpp"
+
+#include <cstdint>
+#include <vector>
+
+
+namespace cas {
+
+
+/**
+ * Executes a batch of queries in a single traversal of the index.
+ * Every entry of the DFS stack carries the queries that are still
+ * alive in its subtree; each node is read once per batch, matched
+ * against these queries and its children are visited with the
+ * queries that descend into them. Queries that share a prefix, such
+ * as /usr/include^, therefore share the traversal of that prefix.
+ **/
+template<class VType>
+class BatchQuery {
+  /**
+   * Matching state of one query at one node
+   **/
+  struct LiveQuery {
+    uint32_t query_; // position in keys_
+    PathMatcher::State pm_state_;
+    uint16_t vl_pos_;
+    uint16_t vh_pos_;
+  };
+
+  /**
+   * The live queries of a state are live_[begin_, end_). live_ is
+   * used as a stack as well: the queries of a state are appended
+   * after the ones of all states that are still on the stack.
+   **/
+  struct State {
+    Node* node_;
+    NodeType parent_type_;
+    uint8_t parent_byte_;
+    uint16_t len_pat_;
+    uint16_t len_val_;
+    uint32_t begin_;
+    uint32_t end_;
+  };
+
+  Node* root_;
+  Node* auxiliary_index_;
+  Node* traversal_root_;
+  std::vector<BinarySK>& keys_;
+  PathMatcher& pm_;
+  TaggedBinaryKeyEmitter emitter_;
+  std::vector<uint8_t> buf_pat_;
+  std::vector<uint8_t> buf_val_;
+  std::vector<State> stack_;
+  std::vector<LiveQuery> live_;
+  QueryStats stats_;
+
+public:
+  BatchQuery(Node* root, std::vector<BinarySK>& keys, PathMatcher& pm,
+      TaggedBinaryKeyEmitter emitter);
+
+  void Execute();
+
+  const QueryStats& Stats() const {
+    return stats_;
+  }
+
+  void setAuxiliaryIndex(Node* node);
+
+private:
+  void Traverse(Node* root);
+
+  void UpdateStats(State& s);
+
+  void PrepareBuffer(State& s);
+
+  PathMatcher::PrefixMatch MatchValuePrefix(State& s, LiveQuery& q);
+
+  bool IsCompleteValue(State& s);
+
+  void Descend(State& s);
+
+  void DescendPathNode(State& s);
+
+  void DescendValueNode(State& s);
+
+  bool DescendsAllPathChildren(const LiveQuery& q);
+
+  uint8_t NextPathByte(const LiveQuery& q);
+
+  void ValueByteRange(State& s, const LiveQuery& q, uint8_t& low, uint8_t& high);
+
+  template<class Filter>
+  void PushChild(State& s, Node* child, uint8_t byte, Filter&& filter);
+
+  void EmitMatch(State& s, const LiveQuery& q);
+};
+
+
+} // namespace cas
+
+#endif // CAS_BATCH_QUERY_H_
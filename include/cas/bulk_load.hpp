@@ -3,6 +3,7 @@
 
 #include "cas/binary_key.hpp"
 #include "cas/node.hpp"
+#include "cas/node_allocator.hpp"
 #include <map>
 #include <limits>
 #include <deque>
@@ -13,11 +14,13 @@ namespace cas {
 const size_t DoesNotExist = std::numeric_limits<std::size_t>::max();
 
 class BulkLoad {
+  cas::NodeAllocator& allocator_;
   std::deque<cas::BinaryKey>& keys_;
   cas::NodeType root_split_;
 
 public:
-  BulkLoad(std::deque<cas::BinaryKey>& keys,
+  BulkLoad(cas::NodeAllocator& allocator,
+      std::deque<cas::BinaryKey>& keys,
       cas::NodeType root_split = cas::NodeType::Value);
 
   cas::Node* Execute();
@@ -0,0 +1,37 @@
+#ifndef CAS_CARDINALITY_ESTIMATE_H_
+#define CAS_CARDINALITY_ESTIMATE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace cas {
+
+
+/**
+ * Estimated number of matches of a query together with bounds that
+ * are guaranteed to contain the exact number (lower_ <= exact <=
+ * upper_). The bounds coincide if the estimator could decide every
+ * subtree within its budget.
+ **/
+struct CardinalityEstimate {
+  static const size_t kDefaultMaxDepth = 4;
+  static const size_t kDefaultMaxNodes = 512;
+
+  double estimate_ = 0;
+  uint64_t lower_ = 0;
+  uint64_t upper_ = 0;
+  int32_t read_nodes_ = 0;
+  int64_t runtime_mus_ = 0;
+
+  bool IsExact() const {
+    return lower_ == upper_;
+  }
+
+  void Dump() const;
+};
+
+
+} // namespace cas
+
+#endif // CAS_CARDINALITY_ESTIMATE_H_
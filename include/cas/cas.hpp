@@ -5,12 +5,24 @@
 #include "cas/key.hpp"
 #include "cas/search_key.hpp"
 #include "cas/query_stats.hpp"
+#include "cas/cardinality_estimate.hpp"
 #include "cas/binary_key.hpp"
+#include "cas/batch_query.hpp"
 #include "cas/index_type.hpp"
 #include "cas/node.hpp"
+#include "cas/node_allocator.hpp"
+#include "cas/ordered_query.hpp"
+#include "cas/parallel_query.hpp"
+#include "cas/path_summary.hpp"
+#include "cas/prepared_query.hpp"
+#include "cas/query.hpp"
+#include "cas/query_context.hpp"
+#include "cas/query_cursor.hpp"
 #include "cas/surrogate.hpp"
 #include "cas/insertion_helper.hpp"
 #include "cas/update_type.hpp"
+#include <limits>
+#include <memory>
 #include <vector>
 #include <stack>
 
@@ -27,6 +39,18 @@ public:
   Node *auxiliary_index_ = nullptr; //auxiliary index
   Surrogate surrogate_;
   bool use_surrogate_;
+  NodeAllocator allocator_;
+  // Query searches the auxiliary index on a second thread
+  bool concurrent_auxiliary_query_ = false;
+  // see Query::setPrefetchDistance
+  size_t prefetch_distance_ = cas::Query<VType>::kDefaultPrefetchDistance;
+  // set by EnablePathSummary
+  std::unique_ptr<PathSummary> path_summary_;
+  // queries that match at most this many paths of the summary are
+  // executed as exact-path probes. Every probe descends from the root
+  // again, so only few probes beat a traversal that fans out; queries
+  // without matching paths are rejected regardless.
+  size_t max_path_probes_ = 4;
 
   Cas(IndexType type, const std::vector<std::string>& query_path);
 
@@ -35,6 +59,12 @@ public:
 
   ~Cas();
 
+  /**
+   * Removes all keys from the main and the auxiliary index. The nodes
+   * are released slab by slab without traversing the index.
+   **/
+  void Clear();
+
   cas::QueryStats Insert(Key<VType>& key,
       cas::UpdateType insertTypeMain,
       cas::UpdateType insertTypeAux,
@@ -56,14 +86,125 @@ public:
   const QueryStats Query(SearchKey<VType>& key,
       BinaryKeyEmitter emitter);
 
+  /**
+   * Executes the query with the buffers of context. The other Query
+   * overloads use the context of the calling thread.
+   **/
+  const QueryStats Query(SearchKey<VType>& key,
+      BinaryKeyEmitter emitter, QueryContext& context);
+
+  /**
+   * Calls emitter once per matching leaf with all of its DIDs
+   **/
+  const QueryStats Query(SearchKey<VType>& key,
+      DidSpanEmitter emitter);
+
+  const QueryStats Query(SearchKey<VType>& key,
+      DidSpanEmitter emitter, QueryContext& context);
+
   const QueryStats Query(SearchKey<VType>& key,
       DidEmitter emitter);
 
   const QueryStats Query(SearchKey<VType>& key,
       Emitter<VType> emitter);
 
+  /**
+   * Like Query with an Emitter, but the labels and the value of a
+   * match are only decoded when the emitter accesses them
+   **/
+  const QueryStats Query(SearchKey<VType>& key,
+      MatchViewEmitter<VType> emitter);
+
   const QueryStats QueryRuntime(SearchKey<VType>& key);
 
+  /**
+   * Returns the number of matches of key. Subtrees that lie completely
+   * inside the query are counted from their nr_keys_.
+   **/
+  uint64_t Count(SearchKey<VType>& key);
+
+  uint64_t Count(SearchKey<VType>& key, QueryContext& context);
+
+  /**
+   * Estimates the number of matches of key by descending at most
+   * max_depth levels and reading at most about max_nodes inner nodes.
+   * The exact count lies within the returned bounds.
+   **/
+  CardinalityEstimate Estimate(SearchKey<VType>& key,
+      size_t max_depth = CardinalityEstimate::kDefaultMaxDepth,
+      size_t max_nodes = CardinalityEstimate::kDefaultMaxNodes);
+
+  CardinalityEstimate Estimate(SearchKey<VType>& key, QueryContext& context,
+      size_t max_depth = CardinalityEstimate::kDefaultMaxDepth,
+      size_t max_nodes = CardinalityEstimate::kDefaultMaxNodes);
+
+  /**
+   * Executes the query with nr_threads threads that traverse disjoint
+   * subtrees. The emitter is called on the calling thread only.
+   **/
+  const QueryStats ParallelQuery(SearchKey<VType>& key,
+      BinaryKeyEmitter emitter, size_t nr_threads);
+
+  const QueryStats ParallelQuery(SearchKey<VType>& key,
+      Emitter<VType> emitter, size_t nr_threads);
+
+  /**
+   * Emits the first limit matches of key ordered by value. Only the
+   * subtrees needed for these matches are traversed, which gives the
+   * top-k by value without collecting all matches.
+   **/
+  const QueryStats OrderedQuery(SearchKey<VType>& key,
+      BinaryKeyEmitter emitter, ValueOrder order,
+      size_t limit = std::numeric_limits<size_t>::max());
+
+  const QueryStats OrderedQuery(SearchKey<VType>& key,
+      Emitter<VType> emitter, ValueOrder order,
+      size_t limit = std::numeric_limits<size_t>::max());
+
+  /**
+   * Emits the DIDs that match all keys in ascending order. The keys
+   * are executed from the most to the least selective one according
+   * to Estimate. The matches of every further key are probed against
+   * the DIDs that are left, and once no DID is left the remaining keys
+   * are skipped.
+   **/
+  ConjunctiveQueryStats ConjunctiveQuery(std::vector<SearchKey<VType>>& keys,
+      DidEmitter emitter);
+
+  /**
+   * Executes all keys in a single traversal of the index. Matches are
+   * emitted with the position of their query in keys.
+   **/
+  const QueryStats BatchQuery(std::vector<SearchKey<VType>>& keys,
+      TaggedBinaryKeyEmitter emitter);
+
+  const QueryStats BatchQuery(std::vector<SearchKey<VType>>& keys,
+      TaggedEmitter<VType> emitter);
+
+  /**
+   * Returns a cursor that yields the matches of key on demand
+   **/
+  std::unique_ptr<QueryCursor<VType>> Cursor(SearchKey<VType>& key);
+
+  /**
+   * Encodes and compiles path once for queries that only differ in
+   * their value bounds
+   **/
+  std::unique_ptr<PreparedQuery<VType>> Prepare(const path_t& path);
+
+  /**
+   * Executes a prepared query with the bounds low and high. Several
+   * threads can execute the same prepared query at once.
+   **/
+  const QueryStats Query(const PreparedQuery<VType>& prepared,
+      const VType& low, const VType& high, DidSpanEmitter emitter);
+
+  const QueryStats Query(const PreparedQuery<VType>& prepared,
+      const VType& low, const VType& high, BinaryKeyEmitter emitter);
+
+  const QueryStats Query(const PreparedQuery<VType>& prepared,
+      const VType& low, const VType& high, Emitter<VType> emitter);
+
   void Describe();
 
   void Dump();
@@ -78,12 +219,41 @@ public:
 
   void setAuxiliaryIndex(Node *index);
 
+  /**
+   * Summarizes the paths of the keys in the index and keeps the
+   * summary up to date on bulk load, insert and delete. Query then
+   * resolves its query path against the summary first. Indexes with
+   * surrogates do not keep a summary.
+   **/
+  void EnablePathSummary();
+
+  void DisablePathSummary();
+
   Node* getAuxiliaryIndex();
 
   void mergeMainAndAuxiliaryIndex(cas::MergeMethod merge_method);
 
 private:
-  void DeleteNodesRecursively(Node *node);
+  const QueryStats Execute(SearchKey<VType>& key, BinaryKeyEmitter emitter,
+      DidSpanEmitter span_emitter, QueryContext& context);
+
+  /**
+   * Executes one exact-path probe per path instead of key
+   **/
+  const QueryStats ExecuteProbes(BinarySK& key,
+      const std::vector<PathSummary::Path>& paths, BinaryKeyEmitter emitter,
+      DidSpanEmitter span_emitter, QueryContext& context);
+
+  void SummarizePaths(Node* root);
+
+  const QueryStats Execute(const PreparedQuery<VType>& prepared,
+      const VType& low, const VType& high, DidSpanEmitter span_emitter,
+      QueryContext& context);
+
+  /**
+   * Decodes the matches of a leaf once and emits them to emitter
+   **/
+  DidSpanEmitter DecodingEmitter(Emitter<VType>& emitter);
 
   void DumpLatexRoot();
 };
@@ -2,6 +2,8 @@
 #define CAS_CAS_DELETE_H_
 
 #include "cas/node.hpp"
+#include "cas/did_list.hpp"
+#include "cas/node_allocator.hpp"
 #include "cas/insertion_helper.hpp"
 #include "cas/query_stats.hpp"
 #include "cas/key_encoding.hpp"
@@ -12,6 +14,7 @@
 
 #include <deque>
 #include <stack>
+#include <vector>
 
 namespace cas {
 
@@ -31,6 +34,7 @@ class CasDelete {
     void Dump();
   };
 
+  NodeAllocator& allocator_;
   Node** root_main_;
   Node** root_auxiliary_;
   Node* node_;
@@ -38,14 +42,17 @@ class CasDelete {
   Node* grand_parent_;
   uint8_t parent_byte_; // byte from parent to node
   uint8_t grand_parent_byte_; // byte from grand_parent to parent
+  std::vector<Node*> ancestors_; // inner nodes from the root to node_
   const BinaryKey& key_;
   const cas::UpdateType deletion_method_;
+  size_t nr_deleted_ = 0; // DIDs removed from the leaf
 
 private:
     bool is_main_index_;
 
 public:
   CasDelete(
+      NodeAllocator& allocator,
       Node** root_main,
       Node** root_auxiliary,
       const BinaryKey& key,
@@ -53,12 +60,17 @@ public:
 
   bool Execute();
   bool Execute(Node** root);
+
+  size_t NrDeleted() const {
+    return nr_deleted_;
+  }
+
   void LazyDeletion(Node** root);
   void StrictDeletion(Node** root);
 
 private:
   bool Traverse(Node** root);
-  void DeleteDID(std::vector<did_t>& v, cas::did_t did);
+  size_t DeleteDID(DidList& dids, cas::did_t did);
   void PerformPrefixPullup();
   NodeType Alternate(NodeType type);
 };
@@ -2,6 +2,7 @@
 #define CAS_CAS_INSERT_H_
 
 #include "cas/node.hpp"
+#include "cas/node_allocator.hpp"
 #include "cas/insertion_helper.hpp"
 #include "cas/query_stats.hpp"
 #include "cas/key_encoding.hpp"
@@ -31,6 +32,7 @@ class CasInsert {
     void Dump();
   };
 
+  NodeAllocator& allocator_;
   Node* root_;
   Node* parent_;
   Node* grand_parent_; //grand_parent_ is necessary to know when the node is expanded
@@ -53,6 +55,7 @@ private:
 
 public:
   CasInsert(
+      NodeAllocator& allocator,
       Node* root,
       BinarySK& key,
       cas::InsertionHelper& pm,
@@ -7,6 +7,7 @@
 #include "cas/binary_key.hpp"
 #include "cas/search_key.hpp"
 #include "cas/query_stats.hpp"
+#include "cas/path_matcher.hpp"
 #include <vector>
 #include <deque>
 #include <tuple>
@@ -37,6 +38,12 @@ public:
   const QueryStats Query(SearchKey<VType>& skey,
       Emitter<VType> emitter);
 
+  /**
+   * Calls emitter once per matching key, with a span of its DID
+   **/
+  const QueryStats Query(SearchKey<VType>& skey,
+      DidSpanEmitter emitter);
+
   const QueryStats QueryRuntime(SearchKey<VType>& key);
 
   void Describe();
@@ -56,7 +63,8 @@ public:
 private:
   bool MatchesValue(const BinarySK& skey, const BinaryKey& key);
 
-  bool MatchesPath(const BinarySK& skey, const BinaryKey& key);
+  bool MatchesPath(PathMatcher& pm, const BinarySK& skey,
+      const BinaryKey& key);
 
   std::string CasType();
 };
@@ -0,0 +1,103 @@
+#ifndef CAS_CHILD_BITMAP_H_
+#define CAS_CHILD_BITMAP_H_
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+namespace cas {
+
+
+/**
+ * 256-bit set of the key bytes that have a child in a Node48 or
+ * Node256. Range scans and key enumeration read these 32 bytes
+ * instead of the 256 index bytes of a Node48 or the 2KB of child
+ * pointers of a Node256.
+ **/
+class ChildBitmap {
+  uint64_t words_[4];
+
+public:
+  ChildBitmap() {
+    std::memset(words_, 0, sizeof(words_));
+  }
+
+  inline void Set(uint8_t key_byte) {
+    words_[key_byte >> 6] |= Bit(key_byte);
+  }
+
+  inline void Clear(uint8_t key_byte) {
+    words_[key_byte >> 6] &= ~Bit(key_byte);
+  }
+
+  inline bool Test(uint8_t key_byte) const {
+    return (words_[key_byte >> 6] & Bit(key_byte)) != 0;
+  }
+
+  inline int Count() const {
+    return __builtin_popcountll(words_[0]) + __builtin_popcountll(words_[1]) +
+      __builtin_popcountll(words_[2]) + __builtin_popcountll(words_[3]);
+  }
+
+  /**
+   * Calls callback(key_byte) for the set bytes in [low, high] in
+   * descending order until the callback returns false. Returns false
+   * if the iteration was stopped early.
+   **/
+  template<class Callback>
+  inline bool ForEachDescending(uint8_t low, uint8_t high,
+      Callback&& callback) const {
+    for (int w = high >> 6; w >= (low >> 6); --w) {
+      uint64_t word = words_[w];
+      if (w == (high >> 6)) {
+        word &= ~0ULL >> (63 - (high & 63));
+      }
+      if (w == (low >> 6)) {
+        word &= ~0ULL << (low & 63);
+      }
+      while (word != 0) {
+        int bit = 63 - __builtin_clzll(word);
+        if (!callback(static_cast<uint8_t>((w << 6) | bit))) {
+          return false;
+        }
+        word &= ~(1ULL << bit);
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Calls callback(key_byte) for all set bytes in ascending order
+   **/
+  template<class Callback>
+  inline void ForEachAscending(Callback&& callback) const {
+    for (int w = 0; w < 4; ++w) {
+      uint64_t word = words_[w];
+      while (word != 0) {
+        int bit = __builtin_ctzll(word);
+        callback(static_cast<uint8_t>((w << 6) | bit));
+        word &= word - 1;
+      }
+    }
+  }
+
+  std::vector<uint8_t> ToVector() const {
+    std::vector<uint8_t> key_bytes;
+    key_bytes.reserve(Count());
+    ForEachAscending([&](uint8_t key_byte) {
+      key_bytes.push_back(key_byte);
+    });
+    return key_bytes;
+  }
+
+private:
+  static inline uint64_t Bit(uint8_t key_byte) {
+    return 1ULL << (key_byte & 63);
+  }
+};
+
+
+} // namespace cas
+
+#endif // CAS_CHILD_BITMAP_H_
@@ -0,0 +1,67 @@
+#ifndef CAS_CHILD_REF_H_
+#define CAS_CHILD_REF_H_
+
+#include "cas/node_allocator.hpp"
+#include <cstddef>
+#include <cstdint>
+
+
+namespace cas {
+
+
+class Node;
+
+
+#ifdef CAS_COMPACT_REFS
+
+/**
+ * 32-bit reference to a child node (see NodeAllocator::Encode). It
+ * converts implicitly from and to Node*, so the child arrays of the
+ * inner nodes can be used as if they stored pointers.
+ **/
+class ChildRef {
+  uint32_t ref_;
+
+public:
+  ChildRef() = default;
+
+  ChildRef(std::nullptr_t) : ref_(0) {}
+
+  ChildRef(Node* node) : ref_(NodeAllocator::Encode(node)) {}
+
+  inline operator Node*() const {
+    return NodeAllocator::Decode(ref_);
+  }
+
+  inline Node* operator->() const {
+    return NodeAllocator::Decode(ref_);
+  }
+
+  inline bool operator==(std::nullptr_t) const {
+    return ref_ == 0;
+  }
+
+  inline bool operator!=(std::nullptr_t) const {
+    return ref_ != 0;
+  }
+};
+
+#else
+
+using ChildRef = Node*;
+
+#endif
+
+
+inline const char* ChildRefName() {
+#ifdef CAS_COMPACT_REFS
+  return "compact";
+#else
+  return "pointer";
+#endif
+}
+
+
+} // namespace cas
+
+#endif // CAS_CHILD_REF_H_
@@ -0,0 +1,224 @@
+#ifndef CAS_DID_LIST_H_
+#define CAS_DID_LIST_H_
+
+#include "cas/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+
+namespace cas {
+
+
+/**
+ * Sorted list of the DIDs stored in a leaf. Up to kInlineDids DIDs
+ * are stored inside the object. Larger lists are delta encoded with
+ * LEB128 varints in a heap buffer; appending a DID that is not
+ * smaller than the current maximum is amortized O(1). Inserting
+ * other DIDs and erasing DIDs re-encodes only the delta of the
+ * following DID and shifts the bytes behind it.
+ *
+ * Iteration decodes one DID at a time, so lookups can stop early
+ * without decoding the whole list.
+ **/
+class DidList {
+public:
+  static const size_t kInlineDids = 2;
+  static const size_t kMaxVarintBytes = (8 * sizeof(did_t) + 6) / 7;
+
+  class const_iterator {
+    const did_t* raw_ = nullptr;
+    const uint8_t* pos_ = nullptr;
+    did_t current_ = 0;
+    size_t remaining_ = 0;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = did_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const did_t*;
+    using reference = const did_t&;
+
+    const_iterator() = default;
+
+    const_iterator(const did_t* raw, size_t size)
+      : raw_(raw), remaining_(size) {
+      if (remaining_ > 0) {
+        current_ = *raw_;
+      }
+    }
+
+    const_iterator(const uint8_t* pos, size_t size)
+      : pos_(pos), remaining_(size) {
+      if (remaining_ > 0) {
+        current_ = DecodeVarint(pos_);
+      }
+    }
+
+    inline const did_t& operator*() const {
+      return current_;
+    }
+
+    inline const_iterator& operator++() {
+      if (--remaining_ > 0) {
+        if (raw_ != nullptr) {
+          current_ = *++raw_;
+        } else {
+          current_ += DecodeVarint(pos_);
+        }
+      }
+      return *this;
+    }
+
+    inline const_iterator operator++(int) {
+      const_iterator copy = *this;
+      ++(*this);
+      return copy;
+    }
+
+    inline bool operator==(const const_iterator& other) const {
+      return remaining_ == other.remaining_;
+    }
+
+    inline bool operator!=(const const_iterator& other) const {
+      return remaining_ != other.remaining_;
+    }
+  };
+
+private:
+  struct Encoded {
+    uint8_t* bytes_;
+    did_t last_;
+  };
+
+  uint32_t size_ = 0;
+  uint32_t nr_bytes_ = 0;
+  uint32_t capacity_ = 0; // zero while the DIDs are stored inline
+  union {
+    did_t inline_[kInlineDids];
+    Encoded encoded_;
+  };
+
+public:
+  DidList();
+
+  DidList(const DidList& other);
+
+  DidList(DidList&& other);
+
+  ~DidList();
+
+  DidList& operator=(const DidList& other);
+
+  DidList& operator=(DidList&& other);
+
+  inline bool IsInline() const {
+    return capacity_ == 0;
+  }
+
+  inline size_t size() const {
+    return size_;
+  }
+
+  inline bool empty() const {
+    return size_ == 0;
+  }
+
+  inline const_iterator begin() const {
+    return IsInline()
+      ? const_iterator(inline_, size_)
+      : const_iterator(static_cast<const uint8_t*>(encoded_.bytes_), size_);
+  }
+
+  inline const_iterator end() const {
+    return const_iterator();
+  }
+
+  /**
+   * Adds a DID while keeping the list sorted
+   **/
+  void push_back(did_t did);
+
+  void shrink_to_fit();
+
+  void clear();
+
+  bool Contains(did_t did) const;
+
+  /**
+   * Removes all occurrences of did and returns how many were removed
+   **/
+  size_t Erase(did_t did);
+
+  /**
+   * Number of bytes allocated outside the leaf
+   **/
+  size_t HeapBytes() const {
+    return capacity_;
+  }
+
+  std::vector<did_t> ToVector() const {
+    return std::vector<did_t>(begin(), end());
+  }
+
+  static inline did_t DecodeVarint(const uint8_t*& pos) {
+    did_t value = 0;
+    int shift = 0;
+    while (*pos & 0x80) {
+      value |= static_cast<did_t>(*pos++ & 0x7F) << shift;
+      shift += 7;
+    }
+    value |= static_cast<did_t>(*pos++) << shift;
+    return value;
+  }
+
+private:
+  void Assign(const std::vector<did_t>& sorted_dids);
+
+  void Reserve(size_t nr_bytes);
+
+  void AppendVarint(did_t value);
+
+  /**
+   * Replaces the encoded bytes [begin, end) with nr_bytes bytes and
+   * shifts the remaining bytes accordingly
+   **/
+  void Splice(size_t begin, size_t end, const uint8_t* bytes, size_t nr_bytes);
+
+  static size_t WriteVarint(uint8_t* out, did_t value);
+};
+
+
+/**
+ * The DIDs of one match, i.e., all DIDs of a leaf or a plain array of
+ * DIDs, which are iterated in ascending order
+ **/
+class DidSpan {
+  DidList::const_iterator begin_;
+  size_t size_;
+
+public:
+  DidSpan(const DidList& dids)
+    : begin_(dids.begin()), size_(dids.size()) {}
+
+  DidSpan(const did_t* dids, size_t size)
+    : begin_(dids, size), size_(size) {}
+
+  inline DidList::const_iterator begin() const {
+    return begin_;
+  }
+
+  inline DidList::const_iterator end() const {
+    return DidList::const_iterator();
+  }
+
+  inline size_t size() const {
+    return size_;
+  }
+};
+
+
+} // namespace cas
+
+#endif // CAS_DID_LIST_H_
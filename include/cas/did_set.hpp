@@ -0,0 +1,59 @@
+#ifndef CAS_DID_SET_H_
+#define CAS_DID_SET_H_
+
+#include "cas/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace cas {
+
+
+/**
+ * Set of DIDs against which the matches of a predicate are probed.
+ * Sparse sets are stored as a sorted vector and probed by binary
+ * search; a set whose DIDs are dense within their range is stored as
+ * a bitmap over that range instead, which is no larger and is probed
+ * in O(1).
+ **/
+class DidSet {
+  std::vector<did_t> dids_; // sorted and without duplicates, if sparse
+  std::vector<uint64_t> bitmap_; // bit i stands for min_+i, if dense
+  did_t min_ = 0;
+  did_t max_ = 0;
+  size_t size_ = 0;
+
+public:
+  DidSet() = default;
+
+  /**
+   * Builds the set from dids, which may be unsorted and contain
+   * duplicates
+   **/
+  explicit DidSet(std::vector<did_t>&& dids);
+
+  bool Contains(did_t did) const;
+
+  size_t Size() const {
+    return size_;
+  }
+
+  bool Empty() const {
+    return size_ == 0;
+  }
+
+  bool IsBitmap() const {
+    return !bitmap_.empty();
+  }
+
+  /**
+   * The DIDs in ascending order; decoded from the bitmap of dense sets
+   **/
+  std::vector<did_t> Dids() const;
+};
+
+
+} // namespace cas
+
+#endif // CAS_DID_SET_H_
@@ -1,7 +1,9 @@
 #ifndef CAS_INDEX_H_
 #define CAS_INDEX_H_
 
+#include "cas/did_list.hpp"
 #include "cas/key.hpp"
+#include "cas/match_view.hpp"
 #include "cas/search_key.hpp"
 #include "cas/query_stats.hpp"
 #include "cas/index_stats.hpp"
@@ -16,6 +18,10 @@ namespace cas {
 template<class VType>
 using Emitter = std::function<void(const Key<VType>&)>;
 
+// receives a view into the query buffers instead of a decoded key
+template<class VType>
+using MatchViewEmitter = std::function<void(const MatchView<VType>&)>;
+
 using DidEmitter = std::function<void(did_t)>;
 
 using BinaryEmitter = std::function<void(const std::vector<uint8_t>&)>;
@@ -25,6 +31,24 @@ using BinaryKeyEmitter = std::function<void(
     const std::vector<uint8_t>& buffer_value,
     did_t did)>;
 
+// called once per match with all of its DIDs, which saves a call per
+// DID for leaves with many DIDs
+using DidSpanEmitter = std::function<void(
+    const std::vector<uint8_t>& buffer_path,
+    const std::vector<uint8_t>& buffer_value,
+    const DidSpan& dids)>;
+
+// emitters of batch queries additionally receive the position of the
+// matched query in the batch
+template<class VType>
+using TaggedEmitter = std::function<void(size_t query, const Key<VType>&)>;
+
+using TaggedBinaryKeyEmitter = std::function<void(
+    size_t query,
+    const std::vector<uint8_t>& buffer_path,
+    const std::vector<uint8_t>& buffer_value,
+    did_t did)>;
+
 
 template<class VType>
 class Index {
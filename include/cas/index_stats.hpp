@@ -15,19 +15,38 @@ struct IndexStats {
   size_t nr_value_nodes_ = 0;
   size_t nr_node0_ = 0;
   size_t nr_p_node4_ = 0;
+  size_t nr_p_node8_ = 0;
   size_t nr_p_node16_ = 0;
+  size_t nr_p_node32_ = 0;
   size_t nr_p_node48_ = 0;
   size_t nr_p_node256_ = 0;
   size_t nr_v_node4_ = 0;
+  size_t nr_v_node8_ = 0;
   size_t nr_v_node16_ = 0;
+  size_t nr_v_node32_ = 0;
   size_t nr_v_node48_ = 0;
   size_t nr_v_node256_ = 0;
   size_t size_bytes_ = 0;
+  // size if only Node4/16/48/256 existed (Node8 and Node32 are
+  // counted as the Node16 and Node48 they would otherwise be)
+  size_t size_bytes_classic_ = 0;
   size_t pv_steps = 0;
   size_t pp_steps = 0;
   size_t vv_steps = 0;
   size_t vp_steps = 0;
   size_t max_depth_ = 0;
+  // occupancy of the node allocator (main and auxiliary index)
+  size_t alloc_slabs_ = 0;
+  size_t alloc_reserved_bytes_ = 0;
+  size_t alloc_live_bytes_ = 0;
+  size_t alloc_live_nodes_ = 0;
+  size_t alloc_free_nodes_ = 0;
+  // bytes the live blocks add on top of the node objects to keep
+  // nodes aligned (included in size_bytes_ and alloc_live_bytes_)
+  size_t alloc_padding_bytes_ = 0;
+  // bytes of the child arrays and bytes saved by compact references
+  size_t child_ref_bytes_ = 0;
+  size_t child_ref_saved_bytes_ = 0;
   std::map<size_t,size_t> depth_histo_;
 };
 
@@ -23,6 +23,20 @@ public:
 
   BinarySK Encode(SearchKey<VType>& key, Surrogate& surrogate);
 
+  /**
+   * Encode into an existing search key, reusing its capacity
+   **/
+  void Encode(SearchKey<VType>& key, BinarySK& bkey);
+
+  void Encode(SearchKey<VType>& key, BinarySK& bkey, Surrogate& surrogate,
+      std::vector<uint8_t>& label_buffer);
+
+  /**
+   * Encodes only the value bounds and leaves the query path of bkey
+   * untouched
+   **/
+  void EncodeBounds(const VType& low, const VType& high, BinarySK& bkey);
+
   void EncodeValue(const Key<VType>& key, BinaryKey& bkey);
 
 private:
@@ -42,7 +56,7 @@ private:
   void EncodeInsertKeyPath(SearchKey<VType>& key, BinarySK& bkey);
 
   void EncodeQueryPath(SearchKey<VType>& key, BinarySK& bkey,
-      Surrogate& surrogate);
+      Surrogate& surrogate, std::vector<uint8_t>& label_buffer);
 
   static inline void MemCpyToBuffer(std::vector<uint8_t>& buffer, int& offset,
       const void* value, std::size_t size) {
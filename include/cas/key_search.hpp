@@ -0,0 +1,139 @@
+#ifndef CAS_KEY_SEARCH_H_
+#define CAS_KEY_SEARCH_H_
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) && !defined(CAS_NO_SIMD)
+#define CAS_KEY_SEARCH_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace cas {
+
+
+/**
+ * Search kernels for the sorted key arrays of Node4 to Node32.
+ * SSE2 is used when the compiler targets it (always the case on
+ * x86-64) unless CAS_NO_SIMD is defined; otherwise the scalar
+ * fallback is compiled. Bit i of a mask refers to keys[i], keys past
+ * nr_keys are ignored.
+ **/
+class KeySearch {
+public:
+  static const char* Name() {
+#ifdef CAS_KEY_SEARCH_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+  }
+
+  /**
+   * Returns the position of key_byte in keys or -1
+   **/
+  template<int N>
+  static inline int Find(const uint8_t* keys, int nr_keys, uint8_t key_byte) {
+#ifdef CAS_KEY_SEARCH_SSE2
+    uint32_t mask = EqualBits<N>(keys, key_byte) & ValidMask(nr_keys);
+    return mask == 0 ? -1 : __builtin_ctz(mask);
+#else
+    for (int i = 0; i < nr_keys; ++i) {
+      if (keys[i] == key_byte) {
+        return i;
+      }
+    }
+    return -1;
+#endif
+  }
+
+  /**
+   * Returns the mask of keys k with low <= k <= high
+   **/
+  template<int N>
+  static inline uint32_t RangeMask(const uint8_t* keys, int nr_keys,
+      uint8_t low, uint8_t high) {
+#ifdef CAS_KEY_SEARCH_SSE2
+    return RangeBits<N>(keys, low, high) & ValidMask(nr_keys);
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < nr_keys; ++i) {
+      if (keys[i] >= low && keys[i] <= high) {
+        mask |= 1u << i;
+      }
+    }
+    return mask;
+#endif
+  }
+
+  /**
+   * Position of the highest bit set in a non-empty mask
+   **/
+  static inline int HighestBit(uint32_t mask) {
+    return 31 - __builtin_clz(mask);
+  }
+
+private:
+  static inline uint32_t ValidMask(int nr_keys) {
+    return nr_keys >= 32 ? ~0u : (1u << nr_keys) - 1;
+  }
+
+#ifdef CAS_KEY_SEARCH_SSE2
+  template<int N>
+  static inline __m128i Load(const uint8_t* keys);
+
+  template<int N>
+  static inline uint32_t EqualBits(const uint8_t* keys, uint8_t key_byte) {
+    __m128i cmp = _mm_cmpeq_epi8(Load<N>(keys), _mm_set1_epi8(key_byte));
+    return _mm_movemask_epi8(cmp);
+  }
+
+  template<int N>
+  static inline uint32_t RangeBits(const uint8_t* keys, uint8_t low,
+      uint8_t high) {
+    // unsigned comparisons via min/max: k >= low iff max(k, low) == k
+    __m128i k = Load<N>(keys);
+    __m128i ge_low  = _mm_cmpeq_epi8(_mm_max_epu8(k, _mm_set1_epi8(low)), k);
+    __m128i le_high = _mm_cmpeq_epi8(_mm_min_epu8(k, _mm_set1_epi8(high)), k);
+    return _mm_movemask_epi8(_mm_and_si128(ge_low, le_high));
+  }
+#endif
+};
+
+
+#ifdef CAS_KEY_SEARCH_SSE2
+template<>
+inline __m128i KeySearch::Load<4>(const uint8_t* keys) {
+  int32_t word;
+  std::memcpy(&word, keys, sizeof(word));
+  return _mm_cvtsi32_si128(word);
+}
+
+template<>
+inline __m128i KeySearch::Load<8>(const uint8_t* keys) {
+  return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(keys));
+}
+
+template<>
+inline __m128i KeySearch::Load<16>(const uint8_t* keys) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys));
+}
+
+// 32 keys are compared as two halves of 16
+template<>
+inline uint32_t KeySearch::EqualBits<32>(const uint8_t* keys, uint8_t key_byte) {
+  return EqualBits<16>(keys, key_byte) | (EqualBits<16>(keys + 16, key_byte) << 16);
+}
+
+template<>
+inline uint32_t KeySearch::RangeBits<32>(const uint8_t* keys, uint8_t low,
+    uint8_t high) {
+  return RangeBits<16>(keys, low, high) | (RangeBits<16>(keys + 16, low, high) << 16);
+}
+#endif
+
+
+} // namespace cas
+
+#endif // CAS_KEY_SEARCH_H_
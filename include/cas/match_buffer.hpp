@@ -0,0 +1,58 @@
+#ifndef CAS_MATCH_BUFFER_H_
+#define CAS_MATCH_BUFFER_H_
+
+#include "cas/index.hpp"
+#include "cas/node0.hpp"
+#include "cas/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace cas {
+
+
+/**
+ * Matches that are found on one thread and emitted later on another
+ * one. Every matching leaf contributes a copy of its path and value
+ * bytes, which all of its DIDs share.
+ **/
+class MatchBuffer {
+  struct Match {
+    size_t offset_; // of the path in bytes_, the value follows it
+    uint16_t len_pat_;
+    uint16_t len_val_;
+    did_t did_;
+  };
+
+  std::vector<uint8_t> bytes_;
+  std::vector<Match> matches_;
+
+public:
+  void Append(const std::vector<uint8_t>& buf_pat, uint16_t len_pat,
+      const std::vector<uint8_t>& buf_val, uint16_t len_val,
+      const Node0& leaf);
+
+  /**
+   * Calls emitter for every match in the order in which they were
+   * appended and returns the number of matches
+   **/
+  size_t Emit(BinaryKeyEmitter& emitter) const;
+
+  /**
+   * Like Emit, but calls emitter once per leaf with all its DIDs
+   **/
+  size_t Emit(DidSpanEmitter& emitter) const;
+
+  void Clear();
+
+  size_t Size() const {
+    return matches_.size();
+  }
+};
+
+
+} // namespace cas
+
+#endif // CAS_MATCH_BUFFER_H_
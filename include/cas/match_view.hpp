@@ -0,0 +1,135 @@
+#ifndef CAS_MATCH_VIEW_H_
+#define CAS_MATCH_VIEW_H_
+
+#include "cas/key.hpp"
+#include "cas/surrogate.hpp"
+#include "cas/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+namespace cas {
+
+
+/**
+ * Non-owning view of a label or a string value, like std::string_view
+ **/
+class StringView {
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+
+public:
+  StringView() = default;
+
+  StringView(const char* data, size_t size)
+    : data_(data), size_(size) {}
+
+  StringView(const std::string& str)
+    : data_(str.data()), size_(str.size()) {}
+
+  inline const char* data() const {
+    return data_;
+  }
+
+  inline size_t size() const {
+    return size_;
+  }
+
+  inline bool empty() const {
+    return size_ == 0;
+  }
+
+  inline const char* begin() const {
+    return data_;
+  }
+
+  inline const char* end() const {
+    return data_ + size_;
+  }
+
+  inline std::string ToString() const {
+    return std::string(data_, size_);
+  }
+
+  inline bool operator==(const StringView& other) const {
+    return size_ == other.size_ &&
+      (size_ == 0 || std::memcmp(data_, other.data_, size_) == 0);
+  }
+
+  inline bool operator!=(const StringView& other) const {
+    return !(*this == other);
+  }
+};
+
+
+/**
+ * View of a match that points into the path and value buffers of the
+ * query. Unlike KeyDecoder, which copies every label into a string,
+ * the labels and the value are decoded only when they are accessed.
+ * The view is valid only during the call of the emitter; ToKey copies
+ * the match.
+ **/
+template<class VType>
+class MatchView {
+  const std::vector<uint8_t>& buffer_path_;
+  const std::vector<uint8_t>& buffer_value_;
+  did_t did_;
+  const Surrogate* surrogate_; // set if the paths are surrogates
+
+public:
+  MatchView(const std::vector<uint8_t>& buffer_path,
+      const std::vector<uint8_t>& buffer_value,
+      did_t did,
+      const Surrogate* surrogate = nullptr)
+    : buffer_path_(buffer_path)
+    , buffer_value_(buffer_value)
+    , did_(did)
+    , surrogate_(surrogate)
+  {}
+
+  inline did_t Did() const {
+    return did_;
+  }
+
+  VType Value() const;
+
+  /**
+   * The value without a copy, only available for vstring_t
+   **/
+  StringView StringValue() const;
+
+  /**
+   * Stores the label that starts at pos in label and moves pos past
+   * it. Returns false once all labels are consumed. pos starts at 0.
+   **/
+  bool NextLabel(size_t& pos, StringView& label) const;
+
+  StringView LastLabel() const;
+
+  /**
+   * The i-th label, or an empty view if the path is shorter
+   **/
+  StringView Label(size_t i) const;
+
+  size_t NrLabels() const;
+
+  /**
+   * Decodes the whole match like KeyDecoder
+   **/
+  Key<VType> ToKey() const;
+};
+
+
+template<> vint32_t MatchView<vint32_t>::Value() const;
+template<> vint64_t MatchView<vint64_t>::Value() const;
+template<> vstring_t MatchView<vstring_t>::Value() const;
+template<> StringView MatchView<vstring_t>::StringValue() const;
+
+
+} // namespace cas
+
+#endif // CAS_MATCH_VIEW_H_
@@ -3,6 +3,8 @@
 
 #include "cas/node_type.hpp"
 #include "cas/index_stats.hpp"
+#include "cas/node_prefix.hpp"
+#include "cas/child_ref.hpp"
 #include <cstdint>
 #include <cstring>
 #include <vector>
@@ -14,18 +16,31 @@ namespace cas {
 
 
 class Node;
+class NodeAllocator;
 using ChildIt = std::function<bool(uint8_t, Node&)>;
 
 
+/**
+ * The 48-byte header starts with the fields read during traversals
+ * (vptr, type, width, number of children, separator and the inline
+ * prefix) and ends with nr_keys_, which only insert, delete and
+ * merge maintain. The subclasses put their key arrays directly after
+ * the header, so with the cache line aligned blocks of NodeAllocator
+ * the header and the keys of a Node4, Node8 and Node16 share one
+ * 64-byte line.
+ **/
 class Node {
 public:
+  // hot
   NodeType type_;
+  uint16_t width_;
   uint16_t nr_children_ = 0;
-  size_t nr_keys_ = 0;
   uint16_t separator_pos_ = 0;
-  std::vector<uint8_t> prefix_;
+  NodePrefix prefix_;
+  // cold
+  size_t nr_keys_ = 0;
 
-  Node(NodeType type);
+  Node(NodeType type, uint16_t width);
 
   virtual ~Node() = default;
 
@@ -49,17 +64,25 @@ public:
 
   virtual Node* LocateChild(uint8_t key_byte) = 0;
 
-  virtual Node* Grow() = 0;
+  virtual Node* Grow(NodeAllocator& allocator) = 0;
 
-  virtual Node* Shrink() = 0;
+  virtual Node* Shrink(NodeAllocator& allocator) = 0;
 
   virtual void ReplaceBytePointer(uint8_t key_byte, Node* child) = 0;
 
-  virtual void ForEachChild(uint8_t low, uint8_t high, ChildIt callback) = 0;
+  /**
+   * Calls callback for the children with key bytes in [low, high] in
+   * descending key byte order until it returns false. Returns false
+   * if the iteration was stopped early.
+   *
+   * The subclasses additionally offer a templated VisitChildren that
+   * avoids the std::function; see NodeDispatch::ForEachChild.
+   **/
+  virtual bool ForEachChild(uint8_t low, uint8_t high, ChildIt callback) = 0;
 
-  virtual void ForEachChild(uint8_t low, ChildIt callback);
+  virtual bool ForEachChild(uint8_t low, ChildIt callback);
 
-  virtual void ForEachChild(ChildIt callback);
+  virtual bool ForEachChild(ChildIt callback);
 
   virtual size_t SizeBytes() = 0;
 
@@ -76,7 +99,13 @@ public:
 
   void CollectStats(IndexStats& stats, size_t depth);
 
-  virtual int NodeWidth() = 0;
+  /**
+   * Number of children the node can hold (0/4/8/16/32/48/256); serves as
+   * the tag for NodeDispatch
+   **/
+  inline int NodeWidth() {
+    return width_;
+  }
 
   size_t PathPrefixSize();
 
@@ -117,7 +146,7 @@ public:
 protected:
   void DumpBuffer(uint8_t *buffer, size_t length);
 
-  void DumpAddresses(Node **buffer, size_t length);
+  void DumpAddresses(ChildRef* buffer, size_t length);
 
 };
 
@@ -3,6 +3,7 @@
 
 #include "cas/types.hpp"
 #include "cas/binary_key.hpp"
+#include "cas/did_list.hpp"
 #include "cas/interleaved_key.hpp"
 #include "cas/node.hpp"
 
@@ -11,7 +12,7 @@ namespace cas {
 
 class Node0 : public Node {
 public:
-  std::vector<did_t> dids_;
+  DidList dids_;
 
   Node0();
 
@@ -35,17 +36,23 @@ public:
 
   Node* LocateChild(uint8_t key_byte);
 
-  inline Node* Grow() {
+  inline Node* Grow(NodeAllocator& /*allocator*/) {
     return nullptr;
   }
 
-  inline Node* Shrink() {
+  inline Node* Shrink(NodeAllocator& /*allocator*/) {
     return nullptr;
   }
 
   void ReplaceBytePointer(uint8_t key_byte, Node* child);
 
-  void ForEachChild(uint8_t low, uint8_t high, ChildIt callback);
+  bool ForEachChild(uint8_t low, uint8_t high, ChildIt callback);
+
+  template<class Callback>
+  inline bool VisitChildren(uint8_t /*low*/, uint8_t /*high*/,
+      Callback&& /*callback*/) {
+    return true;
+  }
 
   size_t SizeBytes();
 
@@ -53,8 +60,6 @@ public:
 
   bool ContainsDid(did_t did);
 
-  int NodeWidth();
-
   std::vector<uint8_t> GetKeys();
 
   void DeleteNode(uint8_t key_byte);
@@ -2,6 +2,7 @@
 #define CAS_NODE256_H_
 
 #include "cas/node.hpp"
+#include "cas/child_bitmap.hpp"
 
 
 namespace cas {
@@ -9,7 +10,8 @@ namespace cas {
 
 class Node256 : public Node {
 public:
-  Node* children_[256];
+  ChildRef children_[256];
+  ChildBitmap present_;
 
   Node256(NodeType type);
 
@@ -18,22 +20,29 @@ public:
 
   void Put(uint8_t key_byte, Node* child);
 
-  Node* LocateChild(uint8_t key_byte);
+  inline Node* LocateChild(uint8_t key_byte) {
+    return children_[key_byte];
+  }
 
-  Node* Grow();
+  Node* Grow(NodeAllocator& allocator);
 
-  Node* Shrink();
+  Node* Shrink(NodeAllocator& allocator);
 
   void ReplaceBytePointer(uint8_t key_byte, Node* child);
 
-  void ForEachChild(uint8_t low, uint8_t high, ChildIt callback);
+  bool ForEachChild(uint8_t low, uint8_t high, ChildIt callback);
+
+  template<class Callback>
+  inline bool VisitChildren(uint8_t low, uint8_t high, Callback&& callback) {
+    return present_.ForEachDescending(low, high, [&](uint8_t key_byte) -> bool {
+      return callback(key_byte, *children_[key_byte]);
+    });
+  }
 
   size_t SizeBytes();
 
   void Dump();
 
-  int NodeWidth();
-
   std::vector<uint8_t> GetKeys();
 
   void DeleteNode(uint8_t key_byte);
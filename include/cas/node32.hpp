@@ -0,0 +1,24 @@
+#ifndef CAS_NODE32_H_
+#define CAS_NODE32_H_
+
+#include "cas/sorted_node.hpp"
+
+
+namespace cas {
+
+
+class Node32 : public SortedNode<32> {
+public:
+  Node32(NodeType type);
+
+  bool IsUnderfilled();
+
+  Node* Grow(NodeAllocator& allocator);
+
+  Node* Shrink(NodeAllocator& allocator);
+};
+
+
+} // namespace cas
+
+#endif  // CAS_NODE32_H_
@@ -1,43 +1,21 @@
 #ifndef CAS_NODE4_H_
 #define CAS_NODE4_H_
 
-#include "cas/node.hpp"
+#include "cas/sorted_node.hpp"
 
 
 namespace cas {
 
 
-class Node4 : public Node {
+class Node4 : public SortedNode<4> {
 public:
-  uint8_t keys_[4];
-  Node* children_[4];
-
   Node4(NodeType type);
 
-  bool IsFull();
   bool IsUnderfilled();
 
-  void Put(uint8_t key_byte, Node* child);
-
-  Node* LocateChild(uint8_t key_byte);
-
-  Node* Grow();
-
-  Node* Shrink();
-
-  void ReplaceBytePointer(uint8_t key_byte, Node* child);
-
-  void ForEachChild(uint8_t low, uint8_t high, ChildIt callback);
-
-  size_t SizeBytes();
-
-  void Dump();
-
-  int NodeWidth();
-
-  std::vector<uint8_t> GetKeys();
+  Node* Grow(NodeAllocator& allocator);
 
-  void DeleteNode(uint8_t key_byte);
+  Node* Shrink(NodeAllocator& allocator);
 };
 
 
@@ -2,6 +2,7 @@
 #define CAS_NODE48_H_
 
 #include "cas/node.hpp"
+#include "cas/child_bitmap.hpp"
 
 
 namespace cas {
@@ -12,7 +13,8 @@ const int kEmptyIndex = 0xFF;
 class Node48 : public Node {
 public:
   uint8_t indexes_[256];
-  Node* children_[48];
+  ChildRef children_[48];
+  ChildBitmap present_;
 
   Node48(NodeType type);
 
@@ -21,22 +23,30 @@ public:
 
   void Put(uint8_t key_byte, Node* child);
 
-  Node* LocateChild(uint8_t key_byte);
+  inline Node* LocateChild(uint8_t key_byte) {
+    uint8_t index = indexes_[key_byte];
+    return index == kEmptyIndex ? nullptr : children_[index];
+  }
 
-  Node* Grow();
+  Node* Grow(NodeAllocator& allocator);
 
-  Node* Shrink();
+  Node* Shrink(NodeAllocator& allocator);
 
   void ReplaceBytePointer(uint8_t key_byte, Node* child);
 
-  void ForEachChild(uint8_t low, uint8_t high, ChildIt callback);
+  bool ForEachChild(uint8_t low, uint8_t high, ChildIt callback);
+
+  template<class Callback>
+  inline bool VisitChildren(uint8_t low, uint8_t high, Callback&& callback) {
+    return present_.ForEachDescending(low, high, [&](uint8_t key_byte) -> bool {
+      return callback(key_byte, *children_[indexes_[key_byte]]);
+    });
+  }
 
   size_t SizeBytes();
 
   void Dump();
 
-  int NodeWidth();
-
   std::vector<uint8_t> GetKeys();
 
   void DeleteNode(uint8_t key_byte);
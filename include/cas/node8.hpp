@@ -0,0 +1,24 @@
+#ifndef CAS_NODE8_H_
+#define CAS_NODE8_H_
+
+#include "cas/sorted_node.hpp"
+
+
+namespace cas {
+
+
+class Node8 : public SortedNode<8> {
+public:
+  Node8(NodeType type);
+
+  bool IsUnderfilled();
+
+  Node* Grow(NodeAllocator& allocator);
+
+  Node* Shrink(NodeAllocator& allocator);
+};
+
+
+} // namespace cas
+
+#endif  // CAS_NODE8_H_
@@ -0,0 +1,207 @@
+#ifndef CAS_NODE_ALLOCATOR_H_
+#define CAS_NODE_ALLOCATOR_H_
+
+#include "cas/index_stats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <utility>
+
+
+namespace cas {
+
+
+class Node;
+class Node0;
+class Node4;
+class Node8;
+class Node16;
+class Node32;
+class Node48;
+class Node256;
+
+
+/**
+ * Slab allocator for the nodes of one index. Nodes of the same
+ * size class are carved out of 64KiB slabs and freed nodes are put
+ * on a per-class free list, from where Grow/Shrink/Delete reuse them.
+ *
+ * Release() destroys all nodes at once by sweeping over the slabs
+ * instead of walking the tree and freeing every node individually.
+ *
+ * With CAS_COMPACT_REFS every slab is registered in a process-wide
+ * slab directory, so a node can also be named by a 32-bit reference
+ * (slab id and block offset), see Encode/Decode and ChildRef.
+ **/
+class NodeAllocator {
+public:
+  static const size_t kSlabBytes = 1 << 16;
+  static const size_t kBlockAlign = 16;
+  // inner nodes start at a cache line, leaves only at kBlockAlign
+  // since padding them would add up to 48 bytes per key
+#ifdef CAS_NO_NODE_ALIGNMENT
+  static const size_t kInnerNodeAlign = kBlockAlign;
+#else
+  static const size_t kInnerNodeAlign = 64;
+#endif
+  static const size_t kMaxBlocks = kSlabBytes / kBlockAlign;
+#ifdef CAS_COMPACT_REFS
+  // a reference stores the block offset in units of kBlockAlign in
+  // the low kOffsetBits and the slab id in the remaining bits
+  static const int kOffsetBits = 12;
+  static const uint32_t kMaxSlabs = uint32_t{1} << (32 - kOffsetBits);
+#endif
+
+private:
+  struct Slab {
+    Slab* next_;
+    uint32_t id_;
+    uint32_t size_class_;
+    uint32_t block_size_;
+    uint32_t nr_blocks_;
+    uint32_t nr_used_;
+    uint32_t nr_live_;
+    uint64_t live_[kMaxBlocks / 64];
+
+    uint8_t* Block(size_t i);
+
+    bool IsLive(size_t i) const {
+      return (live_[i / 64] >> (i % 64)) & 1;
+    }
+  };
+
+  struct FreeBlock {
+    FreeBlock* next_;
+  };
+
+  struct SizeClass {
+    size_t block_size_ = 0;
+    size_t node_size_ = 0;
+    Slab* slabs_ = nullptr;
+    FreeBlock* free_list_ = nullptr;
+    size_t nr_slabs_ = 0;
+    size_t nr_live_ = 0;
+    size_t nr_free_ = 0;
+  };
+
+  static const int kNrSizeClasses = 7;
+  SizeClass classes_[kNrSizeClasses];
+
+  // every node type has its own size class, so an inner node never
+  // lands in the Node0 class even if it is small enough to fit there
+  template<class T>
+  struct ClassOf;
+
+#ifdef CAS_COMPACT_REFS
+  static const uint32_t kDirectoryChunk = 1024;
+  struct Directory {
+    std::mutex mutex_;
+    uint32_t next_id_ = 1; // 0 encodes nullptr
+    std::vector<uint32_t> free_ids_;
+    // chunks are never moved while they hold a slab, so lookups do
+    // not need the mutex; empty chunks are freed
+    Slab** chunks_[kMaxSlabs / kDirectoryChunk] = {};
+    uint32_t nr_registered_[kMaxSlabs / kDirectoryChunk] = {};
+  };
+  static Directory directory_;
+#endif
+
+public:
+  NodeAllocator();
+
+  ~NodeAllocator();
+
+  NodeAllocator(const NodeAllocator&) = delete;
+  NodeAllocator& operator=(const NodeAllocator&) = delete;
+
+  /**
+   * Bytes of the block that holds a leaf/inner node of the given size,
+   * i.e., including the padding to the next block boundary
+   **/
+  static constexpr size_t LeafBlockBytes(size_t node_bytes) {
+    return (node_bytes + kBlockAlign - 1) / kBlockAlign * kBlockAlign;
+  }
+
+  static constexpr size_t InnerBlockBytes(size_t node_bytes) {
+    return (node_bytes + kInnerNodeAlign - 1) / kInnerNodeAlign * kInnerNodeAlign;
+  }
+
+  template<class T, class... Args>
+  T* New(Args&&... args) {
+    void* memory = Allocate(ClassOf<T>::value);
+    return new (memory) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * Destroys the node and puts its memory on the free list
+   **/
+  void Delete(Node* node);
+
+  /**
+   * Destroys all nodes and returns all slabs to the system
+   **/
+  void Release();
+
+  void CollectStats(IndexStats& stats) const;
+
+#ifdef CAS_COMPACT_REFS
+  /**
+   * Returns the 32-bit reference of a node allocated by any
+   * NodeAllocator, 0 for nullptr
+   **/
+  static inline uint32_t Encode(const Node* node) {
+    if (node == nullptr) {
+      return 0;
+    }
+    const Slab* slab = SlabOf(const_cast<Node*>(node));
+    uintptr_t offset = reinterpret_cast<uintptr_t>(node) -
+      reinterpret_cast<uintptr_t>(slab);
+    return (slab->id_ << kOffsetBits) | (offset / kBlockAlign);
+  }
+
+  static inline Node* Decode(uint32_t ref) {
+    if (ref == 0) {
+      return nullptr;
+    }
+    uint32_t id = ref >> kOffsetBits;
+    Slab* slab = directory_.chunks_[id / kDirectoryChunk][id % kDirectoryChunk];
+    return reinterpret_cast<Node*>(reinterpret_cast<uint8_t*>(slab) +
+        (ref & ((uint32_t{1} << kOffsetBits) - 1)) * kBlockAlign);
+  }
+#endif
+
+private:
+  template<class T>
+  void InitClass(size_t block_size) {
+    classes_[ClassOf<T>::value].block_size_ = block_size;
+    classes_[ClassOf<T>::value].node_size_ = sizeof(T);
+  }
+
+  void* Allocate(int size_class);
+
+  Slab* NewSlab(SizeClass& size_class);
+
+  static Slab* SlabOf(void* block);
+
+#ifdef CAS_COMPACT_REFS
+  static void Register(Slab* slab);
+
+  static void Unregister(Slab* slab);
+#endif
+};
+
+
+template<> struct NodeAllocator::ClassOf<Node0>   { static const int value = 0; };
+template<> struct NodeAllocator::ClassOf<Node4>   { static const int value = 1; };
+template<> struct NodeAllocator::ClassOf<Node8>   { static const int value = 2; };
+template<> struct NodeAllocator::ClassOf<Node16>  { static const int value = 3; };
+template<> struct NodeAllocator::ClassOf<Node32>  { static const int value = 4; };
+template<> struct NodeAllocator::ClassOf<Node48>  { static const int value = 5; };
+template<> struct NodeAllocator::ClassOf<Node256> { static const int value = 6; };
+
+
+} // namespace cas
+
+#endif // CAS_NODE_ALLOCATOR_H_
@@ -0,0 +1,95 @@
+#ifndef CAS_NODE_DISPATCH_H_
+#define CAS_NODE_DISPATCH_H_
+
+#include "cas/node.hpp"
+#include "cas/node0.hpp"
+#include "cas/node4.hpp"
+#include "cas/node8.hpp"
+#include "cas/node16.hpp"
+#include "cas/node32.hpp"
+#include "cas/node48.hpp"
+#include "cas/node256.hpp"
+#include <utility>
+
+
+namespace cas {
+
+
+/**
+ * Calls the width-specific implementation of a node operation by
+ * switching on Node::NodeWidth() instead of going through the vtable.
+ * Qualified calls let the compiler inline the implementations that
+ * are defined in the node headers.
+ *
+ * Building with -DCAS_VIRTUAL_DISPATCH falls back to virtual calls,
+ * which allows benchmarking both variants.
+ **/
+class NodeDispatch {
+public:
+  static const char* Name() {
+#ifdef CAS_VIRTUAL_DISPATCH
+    return "virtual";
+#else
+    return "switch";
+#endif
+  }
+
+  static inline Node* LocateChild(Node* node, uint8_t key_byte) {
+#ifdef CAS_VIRTUAL_DISPATCH
+    return node->LocateChild(key_byte);
+#else
+    switch (node->NodeWidth()) {
+      case 0:   return nullptr;
+      case 4:   return static_cast<Node4*>(node)->Node4::LocateChild(key_byte);
+      case 8:   return static_cast<Node8*>(node)->Node8::LocateChild(key_byte);
+      case 16:  return static_cast<Node16*>(node)->Node16::LocateChild(key_byte);
+      case 32:  return static_cast<Node32*>(node)->Node32::LocateChild(key_byte);
+      case 48:  return static_cast<Node48*>(node)->Node48::LocateChild(key_byte);
+      case 256: return static_cast<Node256*>(node)->Node256::LocateChild(key_byte);
+      default:  return node->LocateChild(key_byte);
+    }
+#endif
+  }
+
+  /**
+   * Visits the children in [low, high] with a callback that can be
+   * inlined (see Node::ForEachChild for the iteration order). Returns
+   * false if the callback stopped the iteration early.
+   **/
+  template<class Callback>
+  static inline bool ForEachChild(Node* node, uint8_t low, uint8_t high,
+      Callback&& callback) {
+#ifdef CAS_VIRTUAL_DISPATCH
+    return node->ForEachChild(low, high, callback);
+#else
+    switch (node->NodeWidth()) {
+      case 0:
+        return true;
+      case 4:
+        return static_cast<Node4*>(node)->VisitChildren(low, high, callback);
+      case 8:
+        return static_cast<Node8*>(node)->VisitChildren(low, high, callback);
+      case 16:
+        return static_cast<Node16*>(node)->VisitChildren(low, high, callback);
+      case 32:
+        return static_cast<Node32*>(node)->VisitChildren(low, high, callback);
+      case 48:
+        return static_cast<Node48*>(node)->VisitChildren(low, high, callback);
+      case 256:
+        return static_cast<Node256*>(node)->VisitChildren(low, high, callback);
+      default:
+        return node->ForEachChild(low, high, callback);
+    }
+#endif
+  }
+
+  template<class Callback>
+  static inline bool ForEachChild(Node* node, Callback&& callback) {
+    return ForEachChild(node, 0x00, 0xFF, std::forward<Callback>(callback));
+  }
+};
+
+
+} // namespace cas
+
+#endif // CAS_NODE_DISPATCH_H_
@@ -0,0 +1,156 @@
+#ifndef CAS_NODE_PREFIX_H_
+#define CAS_NODE_PREFIX_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+
+namespace cas {
+
+
+/**
+ * Byte string holding the (path and value) prefix of a node.
+ * Prefixes of up to kInlineBytes bytes are stored inside the object,
+ * longer prefixes spill to a heap buffer whose pointer then occupies
+ * the inline bytes. The interface mimics the subset of std::vector
+ * that the index needs.
+ **/
+class NodePrefix {
+public:
+  using value_type = uint8_t;
+  using iterator = uint8_t*;
+  using const_iterator = const uint8_t*;
+
+  static const size_t kInlineBytes = 20;
+
+private:
+  uint16_t size_ = 0;
+  uint16_t capacity_ = kInlineBytes;
+  uint8_t bytes_[kInlineBytes];
+
+public:
+  NodePrefix() = default;
+
+  NodePrefix(const NodePrefix& other);
+
+  NodePrefix(NodePrefix&& other);
+
+  ~NodePrefix();
+
+  NodePrefix& operator=(const NodePrefix& other);
+
+  NodePrefix& operator=(NodePrefix&& other);
+
+  NodePrefix& operator=(const std::vector<uint8_t>& bytes);
+
+  inline bool IsInline() const {
+    return capacity_ <= kInlineBytes;
+  }
+
+  inline uint8_t* data() {
+    return IsInline() ? bytes_ : HeapBuffer();
+  }
+
+  inline const uint8_t* data() const {
+    return IsInline() ? bytes_ : HeapBuffer();
+  }
+
+  inline size_t size() const {
+    return size_;
+  }
+
+  inline size_t capacity() const {
+    return capacity_;
+  }
+
+  inline bool empty() const {
+    return size_ == 0;
+  }
+
+  inline uint8_t& operator[](size_t pos) {
+    return data()[pos];
+  }
+
+  inline const uint8_t& operator[](size_t pos) const {
+    return data()[pos];
+  }
+
+  inline iterator begin() { return data(); }
+  inline iterator end()   { return data() + size_; }
+  inline const_iterator begin() const { return data(); }
+  inline const_iterator end()   const { return data() + size_; }
+
+  inline void push_back(uint8_t byte) {
+    if (size_ == capacity_) {
+      reserve(2 * static_cast<size_t>(capacity_));
+    }
+    data()[size_++] = byte;
+  }
+
+  void reserve(size_t capacity);
+
+  void shrink_to_fit();
+
+  void clear() {
+    size_ = 0;
+  }
+
+  void assign(const uint8_t* first, const uint8_t* last);
+
+  template<class InputIt>
+  iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    size_t offset = pos - data();
+    size_t n = std::distance(first, last);
+    reserve(size_ + n);
+    uint8_t* p = data() + offset;
+    std::memmove(p + n, p, size_ - offset);
+    std::copy(first, last, p);
+    size_ += n;
+    return p;
+  }
+
+  iterator erase(const_iterator pos);
+
+  /**
+   * Hints the CPU to load a spilled prefix into the cache. Inline
+   * prefixes share the cache line of the node header.
+   **/
+  inline void Prefetch() const {
+    if (!IsInline()) {
+      __builtin_prefetch(HeapBuffer());
+    }
+  }
+
+  /**
+   * Number of bytes allocated outside the node
+   **/
+  size_t HeapBytes() const {
+    return IsInline() ? 0 : capacity_;
+  }
+
+  std::vector<uint8_t> ToVector() const {
+    return std::vector<uint8_t>(begin(), end());
+  }
+
+private:
+  uint8_t* HeapBuffer() const {
+    uint8_t* buffer;
+    std::memcpy(&buffer, bytes_, sizeof(buffer));
+    return buffer;
+  }
+
+  void SetHeapBuffer(uint8_t* buffer) {
+    std::memcpy(bytes_, &buffer, sizeof(buffer));
+  }
+
+  void Resize(size_t capacity);
+};
+
+
+} // namespace cas
+
+#endif // CAS_NODE_PREFIX_H_
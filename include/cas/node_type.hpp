@@ -1,10 +1,12 @@
 #ifndef CAS_NODE_TYPE_H_
 #define CAS_NODE_TYPE_H_
 
+#include <cstdint>
+
 namespace cas {
 
 
-enum NodeType {
+enum NodeType : uint8_t {
   Path,
   Value,
   Leaf,
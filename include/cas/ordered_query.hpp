@@ -0,0 +1,119 @@
+#ifndef CAS_ORDERED_QUERY_H_
+#define CAS_ORDERED_QUERY_H_
+
+#include "cas/node.hpp"
+#include "cas/node0.hpp"
+#include "cas/path_matcher.hpp"
+#include "cas/query.hpp"
+#include "cas/query_context.hpp"
+#include "cas/query_stats.hpp"
+#include "cas/search_key.hpp"
+#include "cas/index.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+
+namespace cas {
+
+
+enum class ValueOrder {
+  Ascending,
+  Descending,
+};
+
+
+/**
+ * Query that returns its matches ordered by value. Every index is
+ * searched by a stream of its own: a best-first traversal whose
+ * frontier is a heap of pending subtrees, ordered by the value bytes
+ * that all keys of a subtree share. Since no key of a pending subtree
+ * precedes these bytes, a complete match at the top of the heap comes
+ * before everything that is still pending. The streams of the main
+ * and the auxiliary index are merged match by match, and a caller
+ * that stops after k matches only expands the subtrees needed for
+ * the top-k.
+ *
+ * Matches with equal values are returned in no particular order.
+ **/
+template<class VType>
+class OrderedQuery {
+  using TimePoint = std::chrono::high_resolution_clock::time_point;
+
+  /**
+   * Pending subtree, or a complete match once leaf_ is set
+   **/
+  struct Entry {
+    QueryTask task_;
+    std::vector<uint8_t> bound_; // value bytes shared by the subtree
+    Node0* leaf_;
+  };
+
+  struct Stream {
+    QueryContext context_;
+    std::unique_ptr<Query<VType>> query_;
+    std::vector<Entry> heap_;
+  };
+
+  BinarySK& key_;
+  PathMatcher& pm_;
+  ValueOrder order_;
+  std::vector<std::unique_ptr<Stream>> streams_;
+  std::vector<QueryTask> children_;
+  std::vector<uint8_t> buf_pat_;
+  std::vector<uint8_t> buf_val_;
+  size_t len_pat_ = 0;
+  size_t len_val_ = 0;
+  QueryStats stats_;
+
+public:
+  OrderedQuery(BinarySK& key, PathMatcher& pm, ValueOrder order);
+
+  /**
+   * Adds a stream that searches the index rooted at root
+   **/
+  void AddIndex(Node* root);
+
+  /**
+   * Returns the matching leaf with the next value, or nullptr once
+   * all indexes are exhausted. The buffers hold the path and the
+   * value of the returned leaf until the next call.
+   **/
+  Node0* NextLeaf();
+
+  /**
+   * Emits the matches in value order until limit DIDs are emitted
+   **/
+  void Execute(BinaryKeyEmitter emitter,
+      size_t limit = std::numeric_limits<size_t>::max());
+
+  const std::vector<uint8_t>& BufferPath() const {
+    return buf_pat_;
+  }
+
+  const std::vector<uint8_t>& BufferValue() const {
+    return buf_val_;
+  }
+
+  const QueryStats Stats() const;
+
+private:
+  bool Advance(Stream& stream);
+
+  void Push(Stream& stream, Entry&& entry);
+
+  Entry Pop(Stream& stream);
+
+  bool Precedes(const Entry& a, const Entry& b) const;
+
+  void CopyToBuffer(std::vector<uint8_t>& buffer, size_t& len,
+      const std::vector<uint8_t>& bytes);
+};
+
+
+} // namespace cas
+
+#endif // CAS_ORDERED_QUERY_H_
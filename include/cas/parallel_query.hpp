@@ -0,0 +1,94 @@
+#ifndef CAS_PARALLEL_QUERY_H_
+#define CAS_PARALLEL_QUERY_H_
+
+#include "cas/node.hpp"
+#include "cas/match_buffer.hpp"
+#include "cas/node0.hpp"
+#include "cas/path_matcher.hpp"
+#include "cas/query.hpp"
+#include "cas/query_context.hpp"
+#include "cas/query_stats.hpp"
+#include "cas/search_key.hpp"
+#include "cas/index.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace cas {
+
+
+/**
+ * Executes a query with several threads. The calling thread expands
+ * the frontier of the traversal breadth-first until there are
+ * kTasksPerThread subtrees per thread and deals them out to the
+ * workers. Every worker traverses its subtrees depth-first with its
+ * own buffers, stack and matcher state and steals subtrees from the
+ * other workers once it runs out of work; a busy worker splits off
+ * its largest pending subtree while some worker is idle.
+ *
+ * Workers collect their matches in their own result buffers, which
+ * are emitted on the calling thread after the traversal of the main
+ * and after the one of the auxiliary index. The emitter therefore
+ * does not need to be thread-safe. The index must not be modified
+ * during the query.
+ **/
+template<class VType>
+class ParallelQuery {
+  struct Worker {
+    QueryContext context_;
+    std::unique_ptr<Query<VType>> query_;
+    std::mutex mutex_;
+    std::deque<QueryTask> tasks_;
+    MatchBuffer matches_;
+  };
+
+  Node* root_;
+  Node* auxiliary_index_;
+  BinarySK& key_;
+  PathMatcher& pm_;
+  BinaryKeyEmitter emitter_;
+  size_t nr_threads_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> nr_pending_; // tasks that are not finished yet
+  std::atomic<size_t> nr_idle_;    // workers that look for a task
+  QueryStats stats_;
+
+public:
+  static const size_t kTasksPerThread = 8;
+
+  ParallelQuery(Node* root, BinarySK& key, PathMatcher& pm,
+      BinaryKeyEmitter emitter, size_t nr_threads);
+
+  void Execute();
+
+  const QueryStats& Stats() const {
+    return stats_;
+  }
+
+  void setAuxiliaryIndex(Node* node);
+
+private:
+  void Traverse(Node* root);
+
+  void Work(size_t id);
+
+  void Run(Worker& worker, const QueryTask& task);
+
+  bool PopTask(Worker& worker, QueryTask& task);
+
+  bool StealTask(size_t id, QueryTask& task);
+
+  void Collect(Worker& worker, Node0* leaf);
+
+  void EmitMatches();
+};
+
+
+} // namespace cas
+
+#endif // CAS_PARALLEL_QUERY_H_
@@ -0,0 +1,102 @@
+#ifndef CAS_PATH_AUTOMATON_H_
+#define CAS_PATH_AUTOMATON_H_
+
+#include "cas/path_matcher.hpp"
+#include "cas/search_key.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace cas {
+
+
+/**
+ * A query path compiled into a bit-parallel NFA. Bit i of the state
+ * is set if the path bytes consumed so far can be matched by the
+ * first i query bytes. A descendant-or-self step at position i owns a
+ * second bit (in the upper half of the state) that stays set while
+ * the step absorbs further labels. Every path byte updates the state
+ * with a few word operations, so a mismatch never rescans the path
+ * the way the backtracking of PathMatcher does.
+ *
+ * The state is kept in PathMatcher::State::nfa_, while ppos_ is the
+ * number of path bytes consumed so far.
+ **/
+class PathAutomaton {
+  BinaryQP query_path_;     // copy of the compiled path
+  size_t bytes_per_label_; // 0 for paths with separators
+  size_t nr_bytes_;        // length of surrogate paths
+  uint32_t match_[256];    // positions that consume the byte
+  uint32_t child_;
+  uint32_t descendant_;
+  uint32_t accept_;
+
+public:
+  // one bit per query byte and one for the complete query
+  static const size_t kMaxQueryLength = 31;
+
+  static bool Compilable(const BinaryQP& query_path);
+
+  /**
+   * Compiles query_path for paths whose labels are separated by
+   * kPathSep and which are terminated by kNullByte
+   **/
+  PathAutomaton(const BinaryQP& query_path);
+
+  /**
+   * Compiles query_path for surrogate paths of nr_bytes bytes with
+   * labels of bytes_per_label bytes
+   **/
+  PathAutomaton(const BinaryQP& query_path, size_t bytes_per_label,
+      size_t nr_bytes);
+
+  /**
+   * True if the automaton was compiled from a path with the same
+   * bytes as query_path
+   **/
+  bool CompiledFrom(const BinaryQP& query_path) const {
+    return query_path.bytes_ == query_path_.bytes_ &&
+      query_path.types_ == query_path_.types_;
+  }
+
+  PathMatcher::PrefixMatch MatchPathIncremental(
+      const std::vector<uint8_t>& path,
+      size_t len_path,
+      PathMatcher::State& state) const;
+
+  bool MatchesAllExtensions(const PathMatcher::State& state) const;
+
+  bool MatchesAnyNextByte(const PathMatcher::State& state) const;
+
+  uint8_t NextByte(const PathMatcher::State& state) const;
+
+private:
+  void Compile();
+
+  PathMatcher::PrefixMatch MatchSeparated(
+      const std::vector<uint8_t>& path,
+      size_t len_path,
+      PathMatcher::State& state) const;
+
+  PathMatcher::PrefixMatch MatchSurrogate(
+      const std::vector<uint8_t>& path,
+      size_t len_path,
+      PathMatcher::State& state) const;
+
+  void CloseDescendants(size_t ppos, uint32_t& active,
+      uint32_t& inside) const;
+
+  static uint32_t Active(const PathMatcher::State& state);
+
+  static uint32_t Inside(const PathMatcher::State& state);
+
+  static void Store(PathMatcher::State& state, uint32_t active,
+      uint32_t inside);
+};
+
+
+} // namespace cas
+
+#endif // CAS_PATH_AUTOMATON_H_
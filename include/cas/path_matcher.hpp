@@ -4,12 +4,16 @@
 #include "cas/search_key.hpp"
 #include "cas/surrogate.hpp"
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 
 namespace cas {
 
 
+class PathAutomaton;
+
+
 class PathMatcher {
 public:
   enum PrefixMatch {
@@ -23,10 +27,21 @@ public:
     uint16_t qpos_ = 0;
     uint16_t desc_ppos_ = 0;
     int16_t  desc_qpos_ = -1;
+    uint64_t nfa_ = 0; // state of a compiled matcher
 
     void Dump();
   };
 
+  PathMatcher();
+
+  virtual ~PathMatcher();
+
+  /**
+   * Compiles query_path into a PathAutomaton, which then matches
+   * query_path instead of the backtracking interpreter. Query paths
+   * longer than PathAutomaton::kMaxQueryLength are interpreted.
+   **/
+  virtual void Compile(const cas::BinaryQP& query_path);
 
   virtual PrefixMatch MatchPathIncremental(
       const std::vector<uint8_t>& path,
@@ -39,6 +54,36 @@ public:
       const std::vector<uint8_t>& path,
       const cas::BinaryQP& query_path);
 
+  /**
+   * Returns true if every extension of the path prefix that led to
+   * state matches the query path, which is the case once the query
+   * has been consumed up to a trailing descendant-or-self step.
+   * Returning false is always safe.
+   **/
+  virtual bool MatchesAllExtensions(
+      const cas::BinaryQP& query_path,
+      const State& state);
+
+  /**
+   * Returns true if more than one path byte can follow the path
+   * prefix that led to state, e.g., in a wildcard step
+   **/
+  bool MatchesAnyNextByte(
+      const cas::BinaryQP& query_path,
+      const State& state);
+
+  /**
+   * Returns the only path byte that can follow the path prefix that
+   * led to state (see MatchesAnyNextByte)
+   **/
+  uint8_t NextByte(
+      const cas::BinaryQP& query_path,
+      const State& state);
+
+protected:
+  std::unique_ptr<PathAutomaton> automaton_;
+
+  const PathAutomaton* Automaton(const cas::BinaryQP& query_path) const;
 };
 
 
@@ -48,11 +93,17 @@ class SurrogatePathMatcher : public PathMatcher {
 public:
   SurrogatePathMatcher(Surrogate& surrogate);
 
+  virtual void Compile(const cas::BinaryQP& query_path);
+
   virtual PrefixMatch MatchPathIncremental(
       const std::vector<uint8_t>& path,
       const cas::BinaryQP& query_path,
       size_t len_path,
       State& state);
+
+  virtual bool MatchesAllExtensions(
+      const cas::BinaryQP& query_path,
+      const State& state);
 };
 
 
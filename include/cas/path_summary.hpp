@@ -0,0 +1,88 @@
+#ifndef CAS_PATH_SUMMARY_H_
+#define CAS_PATH_SUMMARY_H_
+
+#include "cas/path_matcher.hpp"
+#include "cas/search_key.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace cas {
+
+
+/**
+ * Path summary (DataGuide) of an index: a trie of the distinct label
+ * paths of its keys, with the number of keys of every path. A query
+ * path is resolved against the summary into the paths that it
+ * matches, which are far fewer than the keys of the index. A query
+ * without matching paths needs no traversal at all, and a wildcard
+ * query with few matching paths becomes one exact-path probe per
+ * path, which descends a single path in the path dimension instead of
+ * fanning out over every child.
+ *
+ * Paths are given in their binary encoding: every label is preceded
+ * by kPathSep and the path is terminated by kNullByte.
+ **/
+class PathSummary {
+  struct Node {
+    size_t nr_keys_ = 0; // keys whose path ends here
+    std::map<std::string, std::unique_ptr<Node>> children_;
+  };
+
+  Node root_;
+  size_t nr_paths_ = 0;
+  size_t nr_keys_ = 0;
+
+public:
+  struct Path {
+    BinaryQP query_path_; // matches exactly this path
+    size_t nr_keys_;
+  };
+
+  void Add(const std::vector<uint8_t>& path, size_t nr_keys = 1);
+
+  /**
+   * Removes nr_keys keys of path; a path without keys is removed
+   **/
+  void Remove(const std::vector<uint8_t>& path, size_t nr_keys = 1);
+
+  void Clear();
+
+  size_t NrKeys(const std::vector<uint8_t>& path) const;
+
+  size_t NrPaths() const {
+    return nr_paths_;
+  }
+
+  size_t NrKeys() const {
+    return nr_keys_;
+  }
+
+  /**
+   * Appends the paths that match query_path to paths. Returns false,
+   * and stops, once more than max_paths paths match.
+   **/
+  bool Resolve(const BinaryQP& query_path, PathMatcher& pm,
+      size_t max_paths, std::vector<Path>& paths) const;
+
+private:
+  bool Resolve(const Node& node, const BinaryQP& query_path,
+      PathMatcher& pm, size_t max_paths, std::vector<uint8_t>& buffer,
+      size_t len, const PathMatcher::State& state,
+      std::vector<Path>& paths) const;
+
+  static void Split(const std::vector<uint8_t>& path,
+      std::vector<std::string>& labels);
+
+  static BinaryQP ToQueryPath(const std::vector<uint8_t>& buffer, size_t len);
+};
+
+
+} // namespace cas
+
+#endif // CAS_PATH_SUMMARY_H_
@@ -0,0 +1,57 @@
+#ifndef CAS_PREPARED_QUERY_H_
+#define CAS_PREPARED_QUERY_H_
+
+#include "cas/path_matcher.hpp"
+#include "cas/search_key.hpp"
+#include "cas/surrogate.hpp"
+#include "cas/types.hpp"
+#include <memory>
+
+
+namespace cas {
+
+
+/**
+ * Query path that is encoded and compiled once and then executed with
+ * different value bounds (see Cas::Prepare). Encoding parses the axis
+ * steps and, for surrogate indexes, maps every label, so executions of
+ * a prepared query only encode their bounds.
+ *
+ * The prepared query is not modified by its executions, so threads
+ * can execute it concurrently. It must only be executed on the index
+ * that prepared it.
+ **/
+template<class VType>
+class PreparedQuery {
+  BinaryQP path_;
+  std::unique_ptr<PathMatcher> pm_; // compiled for path_
+  Surrogate* surrogate_;
+
+public:
+  /**
+   * surrogate is nullptr if the index does not map labels to
+   * surrogates
+   **/
+  PreparedQuery(const path_t& path, Surrogate* surrogate);
+
+  // the compiled matcher refers to path_
+  PreparedQuery(const PreparedQuery&) = delete;
+  PreparedQuery& operator=(const PreparedQuery&) = delete;
+
+  const BinaryQP& QueryPath() const {
+    return path_;
+  }
+
+  PathMatcher& Matcher() const {
+    return *pm_;
+  }
+
+  Surrogate* getSurrogate() const {
+    return surrogate_;
+  }
+};
+
+
+} // namespace cas
+
+#endif // CAS_PREPARED_QUERY_H_
@@ -2,13 +2,18 @@
 #define CAS_QUERY_H_
 
 #include "cas/node.hpp"
+#include "cas/node0.hpp"
 #include "cas/path_matcher.hpp"
 #include "cas/query_stats.hpp"
 #include "cas/key_encoding.hpp"
 #include "cas/search_key.hpp"
 #include "cas/index.hpp"
+#include "cas/cardinality_estimate.hpp"
+#include "cas/query_context.hpp"
 
-#include <deque>
+#include <chrono>
+#include <limits>
+#include <memory>
 
 
 namespace cas {
@@ -16,46 +21,168 @@ namespace cas {
 
 template<class VType>
 class Query {
-  struct State {
-    Node* node_; //current node that is being traversed
-    NodeType parent_type_;
-    uint8_t parent_byte_;
-    uint16_t len_pat_;
-    uint16_t len_val_;
-    PathMatcher::State pm_state_;
-    uint16_t vl_pos_;
-    uint16_t vh_pos_;
-
-    void Dump();
-  };
+  using State = QueryState;
+  using TimePoint = std::chrono::high_resolution_clock::time_point;
+
+  enum class Phase { kStart, kMain, kAux, kTask, kDone };
 
   Node* root_;
   BinarySK& key_;
+  const BinaryQP* query_path_;
   PathMatcher& pm_;
   BinaryKeyEmitter emitter_;
-  std::vector<uint8_t> buf_pat_;
-  std::vector<uint8_t> buf_val_;
-  std::deque<State> stack_;
+  DidSpanEmitter span_emitter_;
+  std::unique_ptr<QueryContext> own_context_;
+  QueryContext& context_;
+  std::vector<uint8_t>& buf_pat_;
+  std::vector<uint8_t>& buf_val_;
+  std::vector<State>& stack_;
   QueryStats stats_;
 
   Node* auxiliary_index_;
+  Node* traversal_root_ = nullptr;
+  Phase phase_ = Phase::kStart;
+  bool concurrent_auxiliary_ = false;
+  bool count_subtrees_ = false;
+  uint64_t nr_counted_ = 0;
+  size_t max_depth_ = std::numeric_limits<size_t>::max();
+  size_t max_nodes_ = std::numeric_limits<size_t>::max();
+  uint64_t estimated_upper_ = 0;
+  double estimated_keys_ = 0;
+  TimePoint t_start_;
+  TimePoint t_phase_;
+  uint16_t leaf_len_pat_ = 0;
+  uint16_t leaf_len_val_ = 0;
+  size_t prefetch_distance_ = kDefaultPrefetchDistance;
+  // nodes whose headers were prefetched on the previous visit and
+  // whose spilled prefixes are prefetched on the next one
+  Node* prefix_pending_ = nullptr;
+  size_t prefix_from_ = 0;
 
 public:
+  static const size_t kDefaultPrefetchDistance = 4;
+
   Query(Node* root, BinarySK& key, cas::PathMatcher& pm,
       BinaryKeyEmitter emitter);
 
+  /**
+   * Uses the buffers and the stack of context instead of allocating
+   * its own ones
+   **/
+  Query(Node* root, BinarySK& key, cas::PathMatcher& pm,
+      BinaryKeyEmitter emitter, QueryContext& context);
+
   void Execute();
 
+  /**
+   * Resumes the traversal of the main and then of the auxiliary index
+   * until the next matching leaf and returns it, or nullptr once both
+   * indexes are exhausted. The traversal is suspended in between, so
+   * a caller that stops early only pays for the subtrees visited so
+   * far. The buffers hold the path and the value of the returned leaf
+   * until the next call.
+   **/
+  Node0* NextLeaf();
+
+  /**
+   * Continues the traversal in the subtree of task. NextLeaf then
+   * returns the matching leaves of this subtree only.
+   **/
+  void Resume(const QueryTask& task);
+
+  /**
+   * Moves the oldest pending state, which belongs to the largest
+   * subtree that is still to be traversed, into task. Returns false
+   * if less than two states are pending.
+   **/
+  bool Split(QueryTask& task);
+
+  /**
+   * Visits the node of task only and appends a task for every child
+   * that the query descends into. Returns the node if it is a
+   * matching leaf and nullptr otherwise.
+   **/
+  Node0* Expand(const QueryTask& task, std::vector<QueryTask>& children);
+
+  /**
+   * Counts the matches without emitting them. Subtrees whose keys all
+   * match the path and the value predicate contribute their nr_keys_
+   * and are not traversed.
+   **/
+  uint64_t Count();
+
+  /**
+   * Like Count, but subtrees below max_depth or beyond the first
+   * max_nodes inner nodes are not traversed. Their keys widen the
+   * bounds and are scaled by the fraction of their children that the
+   * query would descend into.
+   **/
+  CardinalityEstimate Estimate(size_t max_depth, size_t max_nodes);
+
+  const std::vector<uint8_t>& BufferPath() const {
+    return buf_pat_;
+  }
+
+  const std::vector<uint8_t>& BufferValue() const {
+    return buf_val_;
+  }
+
+  /**
+   * Number of path and value bytes of the leaf returned last
+   **/
+  uint16_t LeafPathLength() const {
+    return leaf_len_pat_;
+  }
+
+  uint16_t LeafValueLength() const {
+    return leaf_len_val_;
+  }
+
   const QueryStats& Stats() const {
     return stats_;
   }
 
   void setAuxiliaryIndex(Node *node);
 
+  /**
+   * Matches the paths against query_path instead of the path of the
+   * search key, e.g., a path that pm was compiled for once
+   **/
+  void setQueryPath(const BinaryQP& query_path);
+
+  /**
+   * Lets Execute search the auxiliary index on a second thread while
+   * the calling thread searches the main index. The matches of the
+   * auxiliary index are buffered and emitted on the calling thread
+   * after the ones of the main index.
+   **/
+  void setConcurrentAuxiliary(bool concurrent);
+
+  /**
+   * Emits every matching leaf with a single call of emitter instead
+   * of calling the BinaryKeyEmitter once per DID
+   **/
+  void setDidSpanEmitter(DidSpanEmitter emitter);
+
+  /**
+   * The nodes of the distance topmost states on the stack are
+   * prefetched, so their headers and prefixes are in the cache once
+   * they are visited. 0 disables prefetching.
+   **/
+  void setPrefetchDistance(size_t distance);
+
 private:
-  void PrepareBuffer(State& s);
+  void ExecuteConcurrently();
+
+  void ResetBuffers();
+
+  void Push(Node* root);
+
+  Node0* Visit();
 
-  void PrepareBufferAuxiliaryIndex(State& s);
+  void MakeTask(const State& s, QueryTask& task);
+
+  void PrepareBuffer(State& s);
 
   PathMatcher::PrefixMatch MatchPathPrefix(State& s);
 
@@ -63,16 +190,31 @@ private:
 
   void Descend(State& s);
 
+  bool DescendsAllPathChildren(State& s);
+
+  uint8_t NextPathByte(State& s);
+
+  void ValueByteRange(State& s, uint8_t& low, uint8_t& high);
+
+  void EstimateSubtree(State& s);
+
   void DescendPathNode(State& s);
 
   void DescendValueNode(State& s);
 
   bool IsCompleteValue(State& s);
 
-  void EmitMatch(State& s);
+  bool IsContained(State& s, PathMatcher::PrefixMatch match_pat,
+      PathMatcher::PrefixMatch match_val);
+
+  void EmitMatch(Node0* leaf);
 
   void UpdateStats(State& s);
 
+  void PrefetchPushed(size_t nr_pushed);
+
+  void PrefetchPending();
+
   void DumpState(State& s);
 
 };
@@ -0,0 +1,128 @@
+#ifndef CAS_QUERY_CONTEXT_H_
+#define CAS_QUERY_CONTEXT_H_
+
+#include "cas/node.hpp"
+#include "cas/node_type.hpp"
+#include "cas/path_matcher.hpp"
+#include "cas/search_key.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace cas {
+
+
+/**
+ * Traversal state of a query at one node
+ **/
+struct QueryState {
+  Node* node_; //current node that is being traversed
+  NodeType parent_type_;
+  uint8_t parent_byte_;
+  uint16_t len_pat_;
+  uint16_t len_val_;
+  PathMatcher::State pm_state_;
+  uint16_t vl_pos_;
+  uint16_t vh_pos_;
+  uint16_t depth_; // number of inner nodes above node_
+
+  void Dump();
+};
+
+
+/**
+ * Pending subtree of a traversal together with the path and value
+ * bytes that lead to it, so that another Query can continue the
+ * traversal there (see Query::Resume)
+ **/
+struct QueryTask {
+  Node* root_; // root of the traversed index
+  QueryState state_;
+  std::vector<uint8_t> path_;
+  std::vector<uint8_t> value_;
+};
+
+
+/**
+ * Buffers that a query needs during its execution: the path and value
+ * buffers, the traversal stack and the encoded search key. A context
+ * keeps its capacity between queries, so reusing it makes repeated
+ * queries free of heap allocations once the buffers have grown to
+ * the size of the largest query.
+ *
+ * A context must only be used by one query at a time.
+ * Cas::Query uses the context of the calling thread (see Acquire)
+ * and falls back to a fresh context if an emitter issues a nested
+ * query.
+ **/
+class QueryContext {
+public:
+  std::vector<uint8_t> buf_pat_;
+  std::vector<uint8_t> buf_val_;
+  std::vector<QueryState> stack_;
+  BinarySK key_;
+  std::vector<uint8_t> label_; // scratch space of the key encoder
+  bool in_use_ = false;
+
+  QueryContext();
+
+  QueryContext(const QueryContext&) = delete;
+  QueryContext& operator=(const QueryContext&) = delete;
+
+  static QueryContext& ForThisThread();
+
+  /**
+   * Context of the auxiliary index search of a query that uses this
+   * context and searches both indexes concurrently; created on first
+   * use and kept for later queries
+   **/
+  QueryContext& Auxiliary();
+
+private:
+  std::unique_ptr<QueryContext> auxiliary_;
+
+public:
+
+  /**
+   * Provides the context of the calling thread, or a fresh context
+   * owned by the lease if the thread's context is in use because an
+   * emitter issued a nested query
+   **/
+  class Lease {
+    std::unique_ptr<QueryContext> nested_;
+    QueryContext* context_;
+
+  public:
+    Lease();
+
+    QueryContext& Get() {
+      return *context_;
+    }
+  };
+
+  static Lease Acquire() {
+    return Lease();
+  }
+
+  /**
+   * Marks a context as used for the lifetime of the guard
+   **/
+  class Guard {
+    QueryContext& context_;
+
+  public:
+    Guard(QueryContext& context) : context_(context) {
+      context_.in_use_ = true;
+    }
+
+    ~Guard() {
+      context_.in_use_ = false;
+    }
+  };
+};
+
+
+} // namespace cas
+
+#endif // CAS_QUERY_CONTEXT_H_
@@ -0,0 +1,92 @@
+#ifndef CAS_QUERY_CURSOR_H_
+#define CAS_QUERY_CURSOR_H_
+
+#include "cas/key.hpp"
+#include "cas/key_decoder.hpp"
+#include "cas/node.hpp"
+#include "cas/path_matcher.hpp"
+#include "cas/query.hpp"
+#include "cas/query_context.hpp"
+#include "cas/query_stats.hpp"
+#include "cas/search_key.hpp"
+#include "cas/surrogate.hpp"
+#include <limits>
+#include <memory>
+
+
+namespace cas {
+
+
+/**
+ * Pull-based query: each call of Next advances the traversal of the
+ * main and then of the auxiliary index to the next match and leaves
+ * the DFS stack suspended until the following call. A cursor with a
+ * Limit stops after that many matches, so paging through the first
+ * results of a large query only touches the subtrees needed for them.
+ *
+ * The cursor owns its buffers and reads the index without locking;
+ * the index must not be modified while a cursor is in use.
+ **/
+template<class VType>
+class QueryCursor {
+  std::unique_ptr<QueryContext> context_;
+  std::unique_ptr<PathMatcher> pm_;
+  std::unique_ptr<Query<VType>> query_;
+  Surrogate* surrogate_;
+  KeyDecoder<VType> decoder_;
+
+  Node0* leaf_ = nullptr;
+  DidList::const_iterator did_it_;
+  did_t did_ = 0;
+  size_t limit_ = std::numeric_limits<size_t>::max();
+  size_t nr_matches_ = 0;
+
+public:
+  /**
+   * surrogate is nullptr if the index does not map labels to
+   * surrogates
+   **/
+  QueryCursor(Node* root, Node* auxiliary_index,
+      SearchKey<VType>& key, Surrogate* surrogate);
+
+  QueryCursor(const QueryCursor&) = delete;
+  QueryCursor& operator=(const QueryCursor&) = delete;
+
+  /**
+   * Returns at most n more matches
+   **/
+  QueryCursor& Limit(size_t n);
+
+  /**
+   * Moves to the next match and returns false once the query is
+   * exhausted or the limit is reached
+   **/
+  bool Next();
+
+  did_t Did() const {
+    return did_;
+  }
+
+  /**
+   * Decodes the current match
+   **/
+  Key<VType> Current();
+
+  const std::vector<uint8_t>& BufferPath() const {
+    return query_->BufferPath();
+  }
+
+  const std::vector<uint8_t>& BufferValue() const {
+    return query_->BufferValue();
+  }
+
+  /**
+   * Statistics of the part of the query executed so far
+   **/
+  QueryStats Stats() const;
+};
+
+
+} // namespace cas
+
+#endif // CAS_QUERY_CURSOR_H_
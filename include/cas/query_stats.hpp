@@ -26,6 +26,25 @@ struct QueryStats {
 };
 
 
+/**
+ * Statistics of a conjunctive query. predicates_ holds the stats of
+ * every predicate in the order in which the predicates were given,
+ * order_ the order in which they were executed and nr_candidates_
+ * the number of DIDs left after each executed predicate. Predicates
+ * that were skipped because no candidates were left are missing in
+ * order_ and have empty stats.
+ **/
+struct ConjunctiveQueryStats {
+  std::vector<QueryStats> predicates_;
+  std::vector<size_t> order_;
+  std::vector<size_t> nr_candidates_;
+  int32_t nr_matches_ = 0;
+  int64_t runtime_mus_ = 0;
+
+  void Dump() const;
+};
+
+
 } // namespace cas
 
 #endif // CAS_QUERY_STATS_H_
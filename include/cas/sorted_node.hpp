@@ -0,0 +1,77 @@
+#ifndef CAS_SORTED_NODE_H_
+#define CAS_SORTED_NODE_H_
+
+#include "cas/node.hpp"
+#include "cas/key_search.hpp"
+
+
+namespace cas {
+
+
+/**
+ * Common implementation of the inner nodes that keep up to N key
+ * bytes in a sorted array next to their children (Node4, Node8,
+ * Node16 and Node32). The subclasses only decide when they are underfilled and
+ * which node they grow into or shrink to.
+ **/
+template<int N>
+class SortedNode : public Node {
+public:
+  uint8_t keys_[N];
+  ChildRef children_[N];
+
+  SortedNode(NodeType type);
+
+  bool IsFull();
+
+  void Put(uint8_t key_byte, Node* child);
+
+  inline Node* LocateChild(uint8_t key_byte) {
+    int pos = KeySearch::Find<N>(keys_, nr_children_, key_byte);
+    return pos < 0 ? nullptr : children_[pos];
+  }
+
+  void ReplaceBytePointer(uint8_t key_byte, Node* child);
+
+  bool ForEachChild(uint8_t low, uint8_t high, ChildIt callback);
+
+  template<class Callback>
+  inline bool VisitChildren(uint8_t low, uint8_t high, Callback&& callback) {
+    uint32_t mask = KeySearch::RangeMask<N>(keys_, nr_children_, low, high);
+    while (mask != 0) {
+      int i = KeySearch::HighestBit(mask);
+      if (!callback(keys_[i], *children_[i])) {
+        return false;
+      }
+      mask &= ~(1u << i);
+    }
+    return true;
+  }
+
+  size_t SizeBytes();
+
+  void Dump();
+
+  std::vector<uint8_t> GetKeys();
+
+  void DeleteNode(uint8_t key_byte);
+
+protected:
+  /**
+   * Moves the prefix and the first nr_children keys and children
+   * into target, which must be at least that wide
+   **/
+  template<int M>
+  void MoveTo(SortedNode<M>* target, int nr_children) {
+    target->nr_children_ = nr_children;
+    target->separator_pos_ = separator_pos_;
+    target->prefix_ = std::move(prefix_);
+    std::memcpy(target->keys_, keys_, nr_children*sizeof(uint8_t));
+    std::memcpy(target->children_, children_, nr_children*sizeof(ChildRef));
+  }
+};
+
+
+} // namespace cas
+
+#endif  // CAS_SORTED_NODE_H_
@@ -22,10 +22,22 @@ public:
 
   std::vector<uint8_t> MapLabel(const std::string& label);
 
+  /**
+   * Appends the surrogate of the label text.substr(pos, size) to bytes
+   **/
+  void MapLabel(const std::string& text, size_t pos, size_t size,
+      std::vector<uint8_t>& bytes);
+
   std::vector<uint8_t> MapPath(const std::vector<std::string>& path);
 
   std::string MapLabelInv(const std::vector<uint8_t>& bytes);
 
+  /**
+   * Returns the label of the bytes_per_label_ bytes at bytes, or
+   * nullptr if the bytes are no surrogate
+   **/
+  const std::string* FindLabel(const uint8_t* bytes) const;
+
   size_t NrBytes() const;
 
 };
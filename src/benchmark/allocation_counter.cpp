@@ -0,0 +1,39 @@
+#include "benchmark/allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+namespace {
+
+// the library allocates from several threads (e.g., concurrent
+// auxiliary index searches)
+std::atomic<size_t> nr_allocations{0};
+
+} // namespace
+
+
+size_t benchmark::NrAllocations() {
+  return nr_allocations.load(std::memory_order_relaxed);
+}
+
+
+void* operator new(std::size_t size) {
+  nr_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) {
+    throw std::bad_alloc{};
+  }
+  return memory;
+}
+
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
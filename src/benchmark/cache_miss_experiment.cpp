@@ -0,0 +1,83 @@
+#include "benchmark/cache_miss_experiment.hpp"
+#include "benchmark/cache_miss_counter.hpp"
+#include "cas/cas.hpp"
+#include "cas/csv_importer.hpp"
+#include <chrono>
+#include <iostream>
+
+
+template<class VType>
+benchmark::CacheMissExperiment<VType>::CacheMissExperiment(
+      const std::string dataset_filename,
+      const char dataset_delim,
+      std::vector<cas::SearchKey<VType>> queries,
+      std::vector<size_t> prefetch_distances
+      )
+  : dataset_filename_(dataset_filename)
+  , dataset_delim_(dataset_delim)
+  , queries_(queries)
+  , prefetch_distances_(prefetch_distances)
+{
+}
+
+
+template<class VType>
+void benchmark::CacheMissExperiment<VType>::Run() {
+  std::cout << "CacheMiss experiment: " << std::endl;
+  std::cout << std::endl;
+
+  int nr_repetitions = 100;
+  cas::Cas<VType> index{cas::IndexType::TwoDimensional, {}};
+  cas::CsvImporter<VType> importer(index, dataset_delim_);
+  importer.BulkLoad(dataset_filename_);
+  index.Describe();
+  std::cout << std::endl;
+
+  benchmark::CacheMissCounter counter;
+  counters_available_ = counter.Available();
+  for (size_t distance : prefetch_distances_) {
+    index.prefetch_distance_ = distance;
+    Result result;
+    result.prefetch_distance_ = distance;
+    // perform queries one after another and then repeat
+    // to avoid caching effects
+    for (int i = 0; i < nr_repetitions; ++i) {
+      for (auto& skey : queries_) {
+        counter.Start();
+        const auto& t_start = std::chrono::high_resolution_clock::now();
+        cas::QueryStats stats = index.QueryRuntime(skey);
+        const auto& t_end = std::chrono::high_resolution_clock::now();
+        counter.Stop();
+        result.read_nodes_ += stats.read_path_nodes_ + stats.read_value_nodes_;
+        result.l1_misses_  += counter.L1Misses();
+        result.llc_misses_ += counter.LlcMisses();
+        result.runtime_mus_ +=
+          std::chrono::duration_cast<std::chrono::microseconds>(t_end-t_start).count();
+      }
+    }
+    results_.push_back(result);
+  }
+  PrintOutput();
+}
+
+
+template<class VType>
+void benchmark::CacheMissExperiment<VType>::PrintOutput() {
+  if (!counters_available_) {
+    std::cout << "cache miss counters are not available" << std::endl;
+  }
+  for (const auto& result : results_) {
+    double nodes = result.read_nodes_ > 0 ? result.read_nodes_ : 1;
+    std::cout << "prefetch_distance: " << result.prefetch_distance_ << std::endl;
+    std::cout << "-visited_nodes: " << result.read_nodes_ << std::endl;
+    std::cout << "-l1_misses_per_node: " << (result.l1_misses_ / nodes) << std::endl;
+    std::cout << "-llc_misses_per_node: " << (result.llc_misses_ / nodes) << std::endl;
+    std::cout << "-runtime_ms: " << (result.runtime_mus_ / 1000.0) << std::endl;
+    std::cout << std::endl;
+  }
+}
+
+// explicit instantiations to separate header from implementation
+template class benchmark::CacheMissExperiment<cas::vint32_t>;
+template class benchmark::CacheMissExperiment<cas::vint64_t>;
+template class benchmark::CacheMissExperiment<cas::vstring_t>;
@@ -58,6 +58,12 @@ void benchmark::SelectivityComputer<VType>::Compute(
   Selectivity(skey, r);
   std::cout << "selectivity:     " << r.nr_matches_ <<
     " (" << r.selectivity_ << "), " << r.runtime_ms_ << "ms" << std::endl;
+  {
+    cas::CardinalityEstimate e = index_.Estimate(skey);
+    std::cout << "estimate:        " << e.estimate_ <<
+      " [" << e.lower_ << ", " << e.upper_ << "], " <<
+      (e.runtime_mus_ / 1000.0) << "ms" << std::endl;
+  }
   {
     cas::SearchKey<VType> s2 = skey;
     SetAllValues(s2);
@@ -122,6 +122,24 @@ void benchmark::SpaceExperiment<VType>::PrintOutput() {
   }
   std::cout << std::endl;
   std::cout << std::endl;
+
+  // bytes/key without the Node8/Node32 widths and the relative change
+  std::cout << "dataset";
+  for (const auto& approach : approaches_) {
+    std::cout << "," << approach.name_ << "_classic";
+    std::cout << "," << approach.name_ << "_change";
+  }
+  std::cout << std::endl;
+  std::cout << "x";
+  for (size_t i = 0; i < approaches_.size(); ++i) {
+    const auto& result = results_[i];
+    double change = result.size_bytes_classic_ == 0 ? 0 :
+      result.size_bytes_ / static_cast<double>(result.size_bytes_classic_) - 1;
+    std::cout << "," << (result.size_bytes_classic_ / static_cast<double>(nr_keys_));
+    std::cout << "," << change;
+  }
+  std::cout << std::endl;
+  std::cout << std::endl;
 }
 
 
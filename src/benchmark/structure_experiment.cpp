@@ -56,12 +56,24 @@ void benchmark::StructureExperiment<VType>::PrintOutput(
     << "," << stats.nr_p_node4_
     << "," << stats.nr_v_node4_
     << std::endl;
+  std::cout << "8"
+    << "," << (stats.nr_p_node8_ + stats.nr_v_node8_)
+    << ",0"
+    << "," << stats.nr_p_node8_
+    << "," << stats.nr_v_node8_
+    << std::endl;
   std::cout << "16"
     << "," << (stats.nr_p_node16_ + stats.nr_v_node16_)
     << ",0"
     << "," << stats.nr_p_node16_
     << "," << stats.nr_v_node16_
     << std::endl;
+  std::cout << "32"
+    << "," << (stats.nr_p_node32_ + stats.nr_v_node32_)
+    << ",0"
+    << "," << stats.nr_p_node32_
+    << "," << stats.nr_v_node32_
+    << std::endl;
   std::cout << "48"
     << "," << (stats.nr_p_node48_ + stats.nr_v_node48_)
     << ",0"
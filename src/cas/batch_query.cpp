@@ -0,0 +1,369 @@
+#include "cas/batch_query.hpp"
+#include "cas/key_encoding.hpp"
+#include "cas/node0.hpp"
+#include "cas/node_dispatch.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+
+template<class VType>
+cas::BatchQuery<VType>::BatchQuery(cas::Node* root,
+        std::vector<cas::BinarySK>& keys,
+        cas::PathMatcher& pm,
+        cas::TaggedBinaryKeyEmitter emitter)
+    : root_(root)
+    , auxiliary_index_(nullptr)
+    , traversal_root_(nullptr)
+    , keys_(keys)
+    , pm_(pm)
+    , emitter_(std::move(emitter))
+    , buf_pat_(cas::kMaxPathLength+1, 0x00)
+    , buf_val_(cas::kMaxValueLength+1, 0x00)
+{}
+
+
+template<class VType>
+void cas::BatchQuery<VType>::Execute() {
+  const auto& t_start_main = std::chrono::high_resolution_clock::now();
+  Traverse(root_);
+  const auto& t_end_main = std::chrono::high_resolution_clock::now();
+  Traverse(auxiliary_index_);
+  const auto& t_end_aux = std::chrono::high_resolution_clock::now();
+
+  stats_.runtime_main_mus_ =
+    std::chrono::duration_cast<std::chrono::microseconds>(t_end_main-t_start_main).count();
+  stats_.runtime_aux_mus_ =
+    std::chrono::duration_cast<std::chrono::microseconds>(t_end_aux-t_end_main).count();
+  stats_.runtime_mus_ =
+    std::chrono::duration_cast<std::chrono::microseconds>(t_end_aux-t_start_main).count();
+}
+
+
+template<class VType>
+void cas::BatchQuery<VType>::Traverse(cas::Node* root) {
+  if (root == nullptr || keys_.empty()) {
+    return;
+  }
+  traversal_root_ = root;
+  std::fill(buf_pat_.begin(), buf_pat_.end(), 0x00);
+  std::fill(buf_val_.begin(), buf_val_.end(), 0x00);
+  stack_.clear();
+  live_.clear();
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    live_.push_back({
+      .query_    = static_cast<uint32_t>(i),
+      .pm_state_ = cas::PathMatcher::State(),
+      .vl_pos_   = 0,
+      .vh_pos_   = 0,
+    });
+  }
+  stack_.push_back({
+    .node_        = root,
+    .parent_type_ = cas::NodeType::Path, // doesn't matter
+    .parent_byte_ = 0x00, // doesn't matter
+    .len_pat_     = 0,
+    .len_val_     = 0,
+    .begin_       = 0,
+    .end_         = static_cast<uint32_t>(live_.size()),
+  });
+
+  while (!stack_.empty()) {
+    State s = stack_.back();
+    stack_.pop_back();
+    // the queries of the states popped before s are no longer needed
+    live_.resize(s.end_);
+
+    UpdateStats(s);
+    PrepareBuffer(s);
+
+    // match the live queries and keep the ones that need to descend
+    uint32_t end = s.begin_;
+    for (uint32_t i = s.begin_; i < s.end_; ++i) {
+      LiveQuery q = live_[i];
+      cas::PathMatcher::PrefixMatch match_pat = pm_.MatchPathIncremental(
+          buf_pat_, keys_[q.query_].path_, s.len_pat_, q.pm_state_);
+      if (match_pat == PathMatcher::MISMATCH) {
+        continue;
+      }
+      cas::PathMatcher::PrefixMatch match_val = MatchValuePrefix(s, q);
+      if (match_val == PathMatcher::MISMATCH) {
+        continue;
+      }
+      if (match_pat == PathMatcher::MATCH &&
+          match_val == PathMatcher::MATCH) {
+        assert(s.node_->IsLeaf());
+        EmitMatch(s, q);
+        continue;
+      }
+      assert(!s.node_->IsLeaf());
+      live_[end++] = q;
+    }
+    s.end_ = end;
+    live_.resize(s.end_);
+
+    if (s.begin_ < s.end_) {
+      Descend(s);
+    }
+  }
+}
+
+
+template<class VType>
+void cas::BatchQuery<VType>::UpdateStats(State& s) {
+  switch (s.node_->type_) {
+  case cas::NodeType::Path:
+    ++stats_.read_path_nodes_;
+    break;
+  case cas::NodeType::Value:
+    ++stats_.read_value_nodes_;
+    break;
+  case cas::NodeType::Leaf:
+    break;
+  }
+}
+
+
+template<class VType>
+void cas::BatchQuery<VType>::PrepareBuffer(State& s) {
+  if (s.node_ != traversal_root_) {
+    switch (s.parent_type_) {
+    case cas::NodeType::Path:
+      buf_pat_[s.len_pat_] = s.parent_byte_;
+      ++s.len_pat_;
+      break;
+    case cas::NodeType::Value:
+      buf_val_[s.len_val_] = s.parent_byte_;
+      ++s.len_val_;
+      break;
+    case cas::NodeType::Leaf:
+      assert(false);
+      break;
+    }
+  }
+  size_t node_pat_len = s.node_->separator_pos_;
+  size_t node_val_len = s.node_->prefix_.size() - s.node_->separator_pos_;
+  std::memcpy(&buf_pat_[s.len_pat_], &s.node_->prefix_[0],
+      node_pat_len);
+  std::memcpy(&buf_val_[s.len_val_], &s.node_->prefix_[s.node_->separator_pos_],
+      node_val_len);
+  s.len_pat_ += node_pat_len;
+  s.len_val_ += node_val_len;
+}
+
+
+template<class VType>
+cas::PathMatcher::PrefixMatch
+cas::BatchQuery<VType>::MatchValuePrefix(State& s, LiveQuery& q) {
+  const cas::BinarySK& key = keys_[q.query_];
+  // match as much as possible of key.low_
+  while (q.vl_pos_ < key.low_.size() &&
+         q.vl_pos_ < s.len_val_ &&
+         buf_val_[q.vl_pos_] == key.low_[q.vl_pos_]) {
+    ++q.vl_pos_;
+  }
+  // match as much as possible of key.high_
+  while (q.vh_pos_ < key.high_.size() &&
+         q.vh_pos_ < s.len_val_ &&
+         buf_val_[q.vh_pos_] == key.high_[q.vh_pos_]) {
+    ++q.vh_pos_;
+  }
+
+  if (q.vl_pos_ < key.low_.size() && q.vl_pos_ < s.len_val_ &&
+      buf_val_[q.vl_pos_] < key.low_[q.vl_pos_]) {
+    // buf_val_ < key.low_
+    return PathMatcher::MISMATCH;
+  }
+
+  if (q.vh_pos_ < key.high_.size() && q.vh_pos_ < s.len_val_ &&
+      buf_val_[q.vh_pos_] > key.high_[q.vh_pos_]) {
+    // buf_val_ > key.high_
+    return PathMatcher::MISMATCH;
+  }
+
+  return IsCompleteValue(s) ? PathMatcher::MATCH : PathMatcher::INCOMPLETE;
+}
+
+
+template<>
+bool cas::BatchQuery<cas::vint32_t>::IsCompleteValue(State& s) {
+  return s.len_val_ == sizeof(cas::vint32_t);
+}
+template<>
+bool cas::BatchQuery<cas::vint64_t>::IsCompleteValue(State& s) {
+  return s.len_val_ == sizeof(cas::vint64_t);
+}
+template<>
+bool cas::BatchQuery<cas::vstring_t>::IsCompleteValue(State& s) {
+  if (s.len_val_ <= 1) {
+    // the null byte alone is no complete value
+    return false;
+  }
+  return buf_val_[s.len_val_ - 1] == '\0';
+}
+
+
+template<class VType>
+void cas::BatchQuery<VType>::Descend(State& s) {
+  switch (s.node_->type_) {
+  case cas::NodeType::Path:
+    DescendPathNode(s);
+    break;
+  case cas::NodeType::Value:
+    DescendValueNode(s);
+    break;
+  case cas::NodeType::Leaf:
+    assert(false);
+    break;
+  }
+}
+
+
+template<class VType>
+bool cas::BatchQuery<VType>::DescendsAllPathChildren(const LiveQuery& q) {
+  if (q.pm_state_.desc_qpos_ != -1) {
+    return true;
+  }
+  const auto& types = keys_[q.query_].path_.types_;
+  if (q.pm_state_.qpos_ >= types.size()) {
+    return false;
+  }
+  return types[q.pm_state_.qpos_] == cas::ByteType::kTypeDescendant ||
+    types[q.pm_state_.qpos_] == cas::ByteType::kTypeWildcard;
+}
+
+
+template<class VType>
+uint8_t cas::BatchQuery<VType>::NextPathByte(const LiveQuery& q) {
+  // once the query path is consumed only the terminating null byte of
+  // the path can still match
+  const auto& bytes = keys_[q.query_].path_.bytes_;
+  if (q.pm_state_.qpos_ >= bytes.size()) {
+    return cas::kNullByte;
+  }
+  return bytes[q.pm_state_.qpos_];
+}
+
+
+template<class VType>
+void cas::BatchQuery<VType>::ValueByteRange(State& s, const LiveQuery& q,
+    uint8_t& low, uint8_t& high) {
+  const cas::BinarySK& key = keys_[q.query_];
+  low  = (q.vl_pos_ == s.len_val_) ? key.low_[q.vl_pos_]  : 0x00;
+  high = (q.vh_pos_ == s.len_val_) ? key.high_[q.vh_pos_] : 0xFF;
+}
+
+
+template<class VType>
+template<class Filter>
+void cas::BatchQuery<VType>::PushChild(State& s, cas::Node* child,
+    uint8_t byte, Filter&& filter) {
+  uint32_t begin = static_cast<uint32_t>(live_.size());
+  for (uint32_t i = s.begin_; i < s.end_; ++i) {
+    // copy, push_back may reallocate live_
+    LiveQuery q = live_[i];
+    if (filter(q)) {
+      live_.push_back(q);
+    }
+  }
+  if (live_.size() == begin) {
+    return;
+  }
+  stack_.push_back({
+    .node_        = child,
+    .parent_type_ = s.node_->type_,
+    .parent_byte_ = byte,
+    .len_pat_     = s.len_pat_,
+    .len_val_     = s.len_val_,
+    .begin_       = begin,
+    .end_         = static_cast<uint32_t>(live_.size()),
+  });
+}
+
+
+template<class VType>
+void cas::BatchQuery<VType>::DescendPathNode(State& s) {
+  bool all_children = false;
+  for (uint32_t i = s.begin_; i < s.end_ && !all_children; ++i) {
+    all_children = DescendsAllPathChildren(live_[i]);
+  }
+
+  if (all_children) {
+    cas::NodeDispatch::ForEachChild(s.node_, [&](uint8_t byte, cas::Node& child) -> bool {
+      PushChild(s, &child, byte, [&](const LiveQuery& q) -> bool {
+        return DescendsAllPathChildren(q) || NextPathByte(q) == byte;
+      });
+      return true;
+    });
+    return;
+  }
+
+  // every query looks for exactly one child; group them by that child
+  std::sort(live_.begin() + s.begin_, live_.begin() + s.end_,
+      [&](const LiveQuery& a, const LiveQuery& b) -> bool {
+    return NextPathByte(a) < NextPathByte(b);
+  });
+  uint32_t i = s.begin_;
+  while (i < s.end_) {
+    uint8_t byte = NextPathByte(live_[i]);
+    uint32_t j = i + 1;
+    while (j < s.end_ && NextPathByte(live_[j]) == byte) {
+      ++j;
+    }
+    cas::Node* child = cas::NodeDispatch::LocateChild(s.node_, byte);
+    if (child != nullptr) {
+      State group = s;
+      group.begin_ = i;
+      group.end_ = j;
+      PushChild(group, child, byte, [](const LiveQuery&) -> bool {
+        return true;
+      });
+    }
+    i = j;
+  }
+}
+
+
+template<class VType>
+void cas::BatchQuery<VType>::DescendValueNode(State& s) {
+  uint8_t low = 0xFF;
+  uint8_t high = 0x00;
+  for (uint32_t i = s.begin_; i < s.end_; ++i) {
+    uint8_t q_low, q_high;
+    ValueByteRange(s, live_[i], q_low, q_high);
+    low  = std::min(low, q_low);
+    high = std::max(high, q_high);
+  }
+  cas::NodeDispatch::ForEachChild(s.node_, low, high,
+      [&](uint8_t byte, cas::Node& child) -> bool {
+    PushChild(s, &child, byte, [&](const LiveQuery& q) -> bool {
+      uint8_t q_low, q_high;
+      ValueByteRange(s, q, q_low, q_high);
+      return q_low <= byte && byte <= q_high;
+    });
+    return true;
+  });
+}
+
+
+template<class VType>
+void cas::BatchQuery<VType>::EmitMatch(State& s, const LiveQuery& q) {
+  assert(s.node_->IsLeaf());
+  cas::Node0* leaf = static_cast<cas::Node0*>(s.node_);
+  for (cas::did_t did : leaf->dids_) {
+    ++stats_.nr_matches_;
+    emitter_(q.query_, buf_pat_, buf_val_, did);
+  }
+}
+
+
+template<class VType>
+void cas::BatchQuery<VType>::setAuxiliaryIndex(cas::Node* node) {
+  auxiliary_index_ = node;
+}
+
+
+// explicit instantiations to separate header from implementation
+template class cas::BatchQuery<cas::vint32_t>;
+template class cas::BatchQuery<cas::vint64_t>;
+template class cas::BatchQuery<cas::vstring_t>;
@@ -1,15 +1,21 @@
 #include "cas/bulk_load.hpp"
 #include "cas/node0.hpp"
 #include "cas/node4.hpp"
+#include "cas/node8.hpp"
 #include "cas/node16.hpp"
+#include "cas/node32.hpp"
 #include "cas/node48.hpp"
 #include "cas/node256.hpp"
+#include "cas/node_dispatch.hpp"
+#include <algorithm>
 #include <iostream>
 
 
-cas::BulkLoad::BulkLoad(std::deque<cas::BinaryKey>& keys,
+cas::BulkLoad::BulkLoad(cas::NodeAllocator& allocator,
+      std::deque<cas::BinaryKey>& keys,
       cas::NodeType root_split)
-  : keys_(keys),
+  : allocator_(allocator),
+  keys_(keys),
   root_split_(root_split) {}
 
 cas::Node* cas::BulkLoad::Execute() {
@@ -34,14 +40,19 @@ cas::Node* cas::BulkLoad::Construct(
 
   if (dp_new == DoesNotExist && dv_new == DoesNotExist) {
     // we reached a leaf node
-    cas::Node0* leaf = new Node0();
+    cas::Node0* leaf = allocator_.New<cas::Node0>();
     leaf->nr_keys_ = indexes.size();
     BuildPrefix(leaf, some_key, dp, dv, dp_new, dv_new);
-    leaf->dids_.reserve(indexes.size());
+    std::vector<cas::did_t> dids;
+    dids.reserve(indexes.size());
     for (size_t index : indexes) {
-      cas::BinaryKey& key = keys_[index];
-      leaf->dids_.push_back(key.did_);
+      dids.push_back(keys_[index].did_);
+    }
+    std::sort(dids.begin(), dids.end());
+    for (cas::did_t did : dids) {
+      leaf->dids_.push_back(did);
     }
+    leaf->dids_.shrink_to_fit();
     return leaf;
   }
 
@@ -56,13 +67,17 @@ cas::Node* cas::BulkLoad::Construct(
 
   cas::Node* node;
   if (partitions.size() <= 4) {
-    node = new Node4(split_type);
+    node = allocator_.New<cas::Node4>(split_type);
+  } else if (partitions.size() <= 8) {
+    node = allocator_.New<cas::Node8>(split_type);
   } else if (partitions.size() <= 16) {
-    node = new Node16(split_type);
+    node = allocator_.New<cas::Node16>(split_type);
+  } else if (partitions.size() <= 32) {
+    node = allocator_.New<cas::Node32>(split_type);
   } else if (partitions.size() <= 48) {
-    node = new Node48(split_type);
+    node = allocator_.New<cas::Node48>(split_type);
   } else {
-    node = new Node256(split_type);
+    node = allocator_.New<cas::Node256>(split_type);
   }
   BuildPrefix(node, some_key, dp, dv, dp_new, dv_new);
 
@@ -77,7 +92,7 @@ cas::Node* cas::BulkLoad::Construct(
     node->Put(it.first, child);
   }
 
-    node->ForEachChild([&](uint8_t, cas::Node& child) -> bool {
+    cas::NodeDispatch::ForEachChild(node, [&](uint8_t, cas::Node& child) -> bool {
         node->nr_keys_ += child.nr_keys_;
         return true;
     });
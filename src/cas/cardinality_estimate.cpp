@@ -0,0 +1,13 @@
+#include "cas/cardinality_estimate.hpp"
+#include <iostream>
+
+
+void cas::CardinalityEstimate::Dump() const {
+  std::cout << "CardinalityEstimate" << std::endl;
+  std::cout << "Estimate: " << estimate_ << std::endl;
+  std::cout << "Lower Bound: " << lower_ << std::endl;
+  std::cout << "Upper Bound: " << upper_ << std::endl;
+  std::cout << "Read Nodes: " << read_nodes_ << std::endl;
+  std::cout << "Runtime (mus): " << runtime_mus_ << std::endl;
+  std::cout << std::endl;
+}
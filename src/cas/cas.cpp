@@ -2,19 +2,26 @@
 #include "cas/key_encoder.hpp"
 #include "cas/node0.hpp"
 #include "cas/node4.hpp"
+#include "cas/key_search.hpp"
+#include "cas/node_dispatch.hpp"
 #include "cas/prefix_matcher.hpp"
 #include "cas/interleaved_key.hpp"
 #include "cas/interleaver.hpp"
 #include "cas/cas_delete.hpp"
 #include "cas/cas_insert.hpp"
 #include "cas/query.hpp"
+#include "cas/batch_query.hpp"
+#include "cas/parallel_query.hpp"
 #include "cas/search_key.hpp"
 #include "cas/key_decoder.hpp"
 #include "cas/utils.hpp"
 #include "cas/bulk_load.hpp"
+#include "cas/did_set.hpp"
 #include <iostream>
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <numeric>
 
 
 template<class VType>
@@ -38,21 +45,19 @@ cas::Cas<VType>::Cas(cas::IndexType type, const std::vector<std::string>& query_
 
 template<class VType>
 cas::Cas<VType>::~Cas() {
-  DeleteNodesRecursively(root_);
-  DeleteNodesRecursively(auxiliary_index_);
+  allocator_.Release();
 }
 
 
 template<class VType>
-void cas::Cas<VType>::DeleteNodesRecursively(cas::Node *node) {
-  if (node == nullptr) {
-    return;
+void cas::Cas<VType>::Clear() {
+  allocator_.Release();
+  root_ = nullptr;
+  auxiliary_index_ = nullptr;
+  nr_keys_ = 0;
+  if (path_summary_ != nullptr) {
+    path_summary_->Clear();
   }
-  node->ForEachChild([&](uint8_t, cas::Node& child) -> bool {
-    DeleteNodesRecursively(&child);
-    return true;
-  });
-  delete node;
 }
 
 
@@ -100,37 +105,43 @@ cas::QueryStats cas::Cas<VType>::Insert(
   mod_path_[bkey.path_.bytes_.size()] = cas::kNullByte;
   bkey.path_.bytes_ = mod_path_;
 
-
-
+  cas::QueryStats stats;
   switch (insert_target) {
     case cas::InsertTarget::MainOnly: {
       // main index only
-      cas::CasInsert<VType> casInsert_main(root_, bkey, pm, key.did_, auxiliary_index_, false);
+      cas::CasInsert<VType> casInsert_main(allocator_, root_, bkey, pm, key.did_, auxiliary_index_, false);
       casInsert_main.Execute(root_, insertTypeMain, auxiliary_index_);
-      return casInsert_main.Stats();
+      stats = casInsert_main.Stats();
+      break;
     }
     case cas::InsertTarget::AuxiliaryOnly: {
       // auxiliary_index_ only
-      cas::CasInsert<VType> casInsert_auxiliary(auxiliary_index_, bkey, pm, key.did_, root_, false);
+      cas::CasInsert<VType> casInsert_auxiliary(allocator_, auxiliary_index_, bkey, pm, key.did_, root_, false);
       casInsert_auxiliary.Execute(auxiliary_index_, insertTypeAux, root_);
-      return casInsert_auxiliary.Stats();
+      stats = casInsert_auxiliary.Stats();
+      break;
     }
     case cas::InsertTarget::MainAuxiliary: {
       // auxiliary_index_ only
-      cas::CasInsert<VType> casInsert_main(root_, bkey, pm, key.did_, auxiliary_index_, true);
-      cas::CasInsert<VType> casInsert_auxiliary(auxiliary_index_, bkey, pm, key.did_, root_, false);
+      cas::CasInsert<VType> casInsert_main(allocator_, root_, bkey, pm, key.did_, auxiliary_index_, true);
+      cas::CasInsert<VType> casInsert_auxiliary(allocator_, auxiliary_index_, bkey, pm, key.did_, root_, false);
       if (casInsert_main.Execute(root_, insertTypeMain, auxiliary_index_) == false){
         casInsert_auxiliary.Execute(auxiliary_index_, insertTypeAux, root_);
       }
-      QueryStats overall_stats;
-      overall_stats.runtime_main_mus_ = casInsert_main.Stats().runtime_mus_;
-      overall_stats.runtime_aux_mus_ = casInsert_auxiliary.Stats().runtime_mus_;
-      overall_stats.runtime_mus_ = overall_stats.runtime_main_mus_ + overall_stats.runtime_aux_mus_;
-      return overall_stats;
+      stats.runtime_main_mus_ = casInsert_main.Stats().runtime_mus_;
+      stats.runtime_aux_mus_ = casInsert_auxiliary.Stats().runtime_mus_;
+      stats.runtime_mus_ = stats.runtime_main_mus_ + stats.runtime_aux_mus_;
+      break;
     }
     default:
       throw std::runtime_error{"option does not exist"};
   }
+
+  // only keys that made it into the index are summarized
+  if (path_summary_ != nullptr) {
+    path_summary_->Add(bkey.path_.bytes_);
+  }
+  return stats;
 }
 
 
@@ -155,11 +166,16 @@ bool cas::Cas<VType>::Delete(
     const cas::BinaryKey& bkey,
     cas::UpdateType deletion_method) {
   cas::CasDelete<VType> deleter{
+    allocator_,
     &root_,
     &auxiliary_index_,
     bkey,
     deletion_method};
-  return deleter.Execute();
+  bool deleted = deleter.Execute();
+  if (path_summary_ != nullptr && deleter.NrDeleted() > 0) {
+    path_summary_->Remove(bkey.path_, deleter.NrDeleted());
+  }
+  return deleted;
 }
 
 
@@ -191,9 +207,17 @@ uint64_t cas::Cas<VType>::BulkLoad(std::deque<cas::Key<VType>>& keys) {
 template<class VType>
 uint64_t cas::Cas<VType>::BulkLoad(std::deque<cas::BinaryKey>& keys, cas::NodeType nodeType) {
   assert(index_type_ == cas::IndexType::TwoDimensional);
-  cas::BulkLoad load(keys, nodeType);
+  cas::BulkLoad load(allocator_, keys, nodeType);
   root_ = load.Execute();
   nr_keys_ = keys.size();
+  if (path_summary_ != nullptr) {
+    // the bulk load replaces the main index
+    path_summary_->Clear();
+    for (const auto& key : keys) {
+      path_summary_->Add(key.path_);
+    }
+    SummarizePaths(auxiliary_index_);
+  }
     return 0;
 }
 
@@ -204,21 +228,75 @@ template<class VType>
 const cas::QueryStats cas::Cas<VType>::Query(
     cas::SearchKey<VType>& key,
     cas::BinaryKeyEmitter emitter) {
+  cas::QueryContext::Lease lease = cas::QueryContext::Acquire();
+  return Query(key, std::move(emitter), lease.Get());
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::Query(
+    cas::SearchKey<VType>& key,
+    cas::BinaryKeyEmitter emitter,
+    cas::QueryContext& context) {
+  return Execute(key, std::move(emitter), nullptr, context);
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::Query(
+    cas::SearchKey<VType>& key,
+    cas::DidSpanEmitter emitter) {
+  cas::QueryContext::Lease lease = cas::QueryContext::Acquire();
+  return Query(key, std::move(emitter), lease.Get());
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::Query(
+    cas::SearchKey<VType>& key,
+    cas::DidSpanEmitter emitter,
+    cas::QueryContext& context) {
+  return Execute(key, nullptr, std::move(emitter), context);
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::Execute(
+    cas::SearchKey<VType>& key,
+    cas::BinaryKeyEmitter emitter,
+    cas::DidSpanEmitter span_emitter,
+    cas::QueryContext& context) {
+  cas::QueryContext::Guard guard(context);
   cas::KeyEncoder<VType> encoder;
+  cas::BinarySK& bkey = context.key_;
   if (use_surrogate_) {
-    cas::BinarySK bkey = encoder.Encode(key, surrogate_);
+    encoder.Encode(key, bkey, surrogate_, context.label_);
     cas::SurrogatePathMatcher pm(surrogate_);
-    cas::Query<VType> query(root_, bkey, pm, emitter);
+    pm.Compile(bkey.path_);
+    cas::Query<VType> query(root_, bkey, pm, std::move(emitter), context);
+    query.setPrefetchDistance(prefetch_distance_);
+    query.setDidSpanEmitter(std::move(span_emitter));
     query.Execute();
     return query.Stats();
   } else {
-    cas::BinarySK bkey = encoder.Encode(key);
+    encoder.Encode(key, bkey);
     cas::PathMatcher pm;
-    cas::Query<VType> query(root_, bkey, pm, emitter);
+    pm.Compile(bkey.path_);
+    if (path_summary_ != nullptr) {
+      std::vector<cas::PathSummary::Path> paths;
+      if (path_summary_->Resolve(bkey.path_, pm, max_path_probes_, paths)) {
+        return ExecuteProbes(bkey, paths, std::move(emitter),
+            std::move(span_emitter), context);
+      }
+    }
+    cas::Query<VType> query(root_, bkey, pm, std::move(emitter), context);
+    query.setPrefetchDistance(prefetch_distance_);
+    query.setDidSpanEmitter(std::move(span_emitter));
 
     //Use of Auxiliary index case
 //  if(auxiliary_index_ != nullptr) std::cout<<"Number of keys in the auxiliary index: " << auxiliary_index_->nr_keys_ << std::endl;
     query.setAuxiliaryIndex(auxiliary_index_);
+    query.setConcurrentAuxiliary(concurrent_auxiliary_query_);
 
     query.Execute();
     return query.Stats();
@@ -226,6 +304,39 @@ const cas::QueryStats cas::Cas<VType>::Query(
 }
 
 
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::ExecuteProbes(
+    cas::BinarySK& key,
+    const std::vector<cas::PathSummary::Path>& paths,
+    cas::BinaryKeyEmitter emitter,
+    cas::DidSpanEmitter span_emitter,
+    cas::QueryContext& context) {
+  const auto& t_start = std::chrono::high_resolution_clock::now();
+  cas::QueryStats stats;
+  // no probe at all if no path matches
+  for (const auto& path : paths) {
+    cas::PathMatcher pm;
+    pm.Compile(path.query_path_);
+    cas::Query<VType> query(root_, key, pm, emitter, context);
+    query.setQueryPath(path.query_path_);
+    query.setPrefetchDistance(prefetch_distance_);
+    query.setDidSpanEmitter(span_emitter);
+    query.setAuxiliaryIndex(auxiliary_index_);
+    query.setConcurrentAuxiliary(concurrent_auxiliary_query_);
+    query.Execute();
+    stats.nr_matches_       += query.Stats().nr_matches_;
+    stats.read_path_nodes_  += query.Stats().read_path_nodes_;
+    stats.read_value_nodes_ += query.Stats().read_value_nodes_;
+    stats.runtime_main_mus_ += query.Stats().runtime_main_mus_;
+    stats.runtime_aux_mus_  += query.Stats().runtime_aux_mus_;
+  }
+  const auto& t_end = std::chrono::high_resolution_clock::now();
+  stats.runtime_mus_ =
+    std::chrono::duration_cast<std::chrono::microseconds>(t_end-t_start).count();
+  return stats;
+}
+
+
 template<class VType>
 const cas::QueryStats cas::Cas<VType>::Query(
     cas::SearchKey<VType>& key,
@@ -233,8 +344,10 @@ const cas::QueryStats cas::Cas<VType>::Query(
   return Query(key, [&](
         const std::vector<uint8_t>& /*buffer_path*/,
         const std::vector<uint8_t>& /*buffer_value*/,
-        cas::did_t did) -> void {
-    emitter(did);
+        const cas::DidSpan& dids) -> void {
+    for (cas::did_t did : dids) {
+      emitter(did);
+    }
   });
 }
 
@@ -243,8 +356,269 @@ template<class VType>
 const cas::QueryStats cas::Cas<VType>::Query(
     cas::SearchKey<VType>& key,
     cas::Emitter<VType> emitter) {
-  cas::KeyDecoder<VType> decoder;
+  return Query(key, DecodingEmitter(emitter));
+}
+
+
+template<class VType>
+cas::DidSpanEmitter cas::Cas<VType>::DecodingEmitter(
+    cas::Emitter<VType>& emitter) {
+  return [this, &emitter](
+        const std::vector<uint8_t>& buffer_path,
+        const std::vector<uint8_t>& buffer_value,
+        const cas::DidSpan& dids) -> void {
+    // the DIDs of a leaf share its path and value, which are decoded
+    // once
+    cas::KeyDecoder<VType> decoder;
+    cas::Key<VType> match = use_surrogate_
+      ? decoder.Decode(surrogate_, buffer_path, buffer_value, 0)
+      : decoder.Decode(buffer_path, buffer_value, 0);
+    for (cas::did_t did : dids) {
+      match.did_ = did;
+      emitter(match);
+    }
+  };
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::Query(
+    cas::SearchKey<VType>& key,
+    cas::MatchViewEmitter<VType> emitter) {
+  const cas::Surrogate* surrogate = use_surrogate_ ? &surrogate_ : nullptr;
   return Query(key, [&](
+        const std::vector<uint8_t>& buffer_path,
+        const std::vector<uint8_t>& buffer_value,
+        const cas::DidSpan& dids) -> void {
+    for (cas::did_t did : dids) {
+      emitter(cas::MatchView<VType>(buffer_path, buffer_value, did, surrogate));
+    }
+  });
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::QueryRuntime(
+    cas::SearchKey<VType>& key) {
+  return Query(key, [&](
+        const std::vector<uint8_t>& /*buffer_path*/,
+        const std::vector<uint8_t>& /*buffer_value*/,
+        const cas::DidSpan& /*dids*/) -> void {
+  });
+}
+
+
+template<class VType>
+uint64_t cas::Cas<VType>::Count(cas::SearchKey<VType>& key) {
+  cas::QueryContext::Lease lease = cas::QueryContext::Acquire();
+  return Count(key, lease.Get());
+}
+
+
+template<class VType>
+uint64_t cas::Cas<VType>::Count(
+    cas::SearchKey<VType>& key,
+    cas::QueryContext& context) {
+  cas::QueryContext::Guard guard(context);
+  cas::KeyEncoder<VType> encoder;
+  cas::BinarySK& bkey = context.key_;
+  if (use_surrogate_) {
+    encoder.Encode(key, bkey, surrogate_, context.label_);
+    cas::SurrogatePathMatcher pm(surrogate_);
+    pm.Compile(bkey.path_);
+    cas::Query<VType> query(root_, bkey, pm, cas::BinaryKeyEmitter(), context);
+    query.setPrefetchDistance(prefetch_distance_);
+    return query.Count();
+  } else {
+    encoder.Encode(key, bkey);
+    cas::PathMatcher pm;
+    pm.Compile(bkey.path_);
+    cas::Query<VType> query(root_, bkey, pm, cas::BinaryKeyEmitter(), context);
+    query.setPrefetchDistance(prefetch_distance_);
+    query.setAuxiliaryIndex(auxiliary_index_);
+    return query.Count();
+  }
+}
+
+
+template<class VType>
+cas::CardinalityEstimate cas::Cas<VType>::Estimate(
+    cas::SearchKey<VType>& key,
+    size_t max_depth,
+    size_t max_nodes) {
+  cas::QueryContext::Lease lease = cas::QueryContext::Acquire();
+  return Estimate(key, lease.Get(), max_depth, max_nodes);
+}
+
+
+template<class VType>
+cas::CardinalityEstimate cas::Cas<VType>::Estimate(
+    cas::SearchKey<VType>& key,
+    cas::QueryContext& context,
+    size_t max_depth,
+    size_t max_nodes) {
+  cas::QueryContext::Guard guard(context);
+  cas::KeyEncoder<VType> encoder;
+  cas::BinarySK& bkey = context.key_;
+  if (use_surrogate_) {
+    encoder.Encode(key, bkey, surrogate_, context.label_);
+    cas::SurrogatePathMatcher pm(surrogate_);
+    pm.Compile(bkey.path_);
+    cas::Query<VType> query(root_, bkey, pm, cas::BinaryKeyEmitter(), context);
+    query.setPrefetchDistance(prefetch_distance_);
+    return query.Estimate(max_depth, max_nodes);
+  } else {
+    encoder.Encode(key, bkey);
+    cas::PathMatcher pm;
+    pm.Compile(bkey.path_);
+    cas::Query<VType> query(root_, bkey, pm, cas::BinaryKeyEmitter(), context);
+    query.setPrefetchDistance(prefetch_distance_);
+    query.setAuxiliaryIndex(auxiliary_index_);
+    return query.Estimate(max_depth, max_nodes);
+  }
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::ParallelQuery(
+    cas::SearchKey<VType>& key,
+    cas::BinaryKeyEmitter emitter,
+    size_t nr_threads) {
+  cas::KeyEncoder<VType> encoder;
+  cas::BinarySK bkey;
+  if (use_surrogate_) {
+    std::vector<uint8_t> label;
+    encoder.Encode(key, bkey, surrogate_, label);
+    cas::SurrogatePathMatcher pm(surrogate_);
+    pm.Compile(bkey.path_);
+    cas::ParallelQuery<VType> query(root_, bkey, pm, std::move(emitter),
+        nr_threads);
+    query.Execute();
+    return query.Stats();
+  } else {
+    encoder.Encode(key, bkey);
+    cas::PathMatcher pm;
+    pm.Compile(bkey.path_);
+    cas::ParallelQuery<VType> query(root_, bkey, pm, std::move(emitter),
+        nr_threads);
+    query.setAuxiliaryIndex(auxiliary_index_);
+    query.Execute();
+    return query.Stats();
+  }
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::ParallelQuery(
+    cas::SearchKey<VType>& key,
+    cas::Emitter<VType> emitter,
+    size_t nr_threads) {
+  cas::KeyDecoder<VType> decoder;
+  return ParallelQuery(key, [&](
+        const std::vector<uint8_t>& buffer_path,
+        const std::vector<uint8_t>& buffer_value,
+        cas::did_t did) -> void {
+    if (use_surrogate_) {
+      emitter(decoder.Decode(surrogate_, buffer_path, buffer_value, did));
+    } else {
+      emitter(decoder.Decode(buffer_path, buffer_value, did));
+    }
+  }, nr_threads);
+}
+
+
+template<class VType>
+cas::ConjunctiveQueryStats cas::Cas<VType>::ConjunctiveQuery(
+    std::vector<cas::SearchKey<VType>>& keys,
+    cas::DidEmitter emitter) {
+  const auto& t_start = std::chrono::high_resolution_clock::now();
+  cas::ConjunctiveQueryStats stats;
+  stats.predicates_.resize(keys.size());
+
+  // the most selective key leaves the fewest candidates to probe
+  std::vector<double> estimates(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    estimates[i] = Estimate(keys[i]).estimate_;
+  }
+  stats.order_.resize(keys.size());
+  std::iota(stats.order_.begin(), stats.order_.end(), 0);
+  std::stable_sort(stats.order_.begin(), stats.order_.end(),
+      [&](size_t a, size_t b) { return estimates[a] < estimates[b]; });
+
+  cas::DidSet candidates;
+  for (size_t i = 0; i < stats.order_.size(); ++i) {
+    size_t predicate = stats.order_[i];
+    std::vector<cas::did_t> matches;
+    if (i == 0) {
+      stats.predicates_[predicate] = Query(keys[predicate],
+          [&](cas::did_t did) -> void {
+        matches.push_back(did);
+      });
+    } else {
+      stats.predicates_[predicate] = Query(keys[predicate],
+          [&](cas::did_t did) -> void {
+        if (candidates.Contains(did)) {
+          matches.push_back(did);
+        }
+      });
+    }
+    candidates = cas::DidSet(std::move(matches));
+    stats.nr_candidates_.push_back(candidates.Size());
+    if (candidates.Empty()) {
+      stats.order_.resize(i + 1);
+      break;
+    }
+  }
+
+  for (cas::did_t did : candidates.Dids()) {
+    emitter(did);
+  }
+  stats.nr_matches_ = static_cast<int32_t>(candidates.Size());
+  const auto& t_end = std::chrono::high_resolution_clock::now();
+  stats.runtime_mus_ =
+    std::chrono::duration_cast<std::chrono::microseconds>(t_end-t_start).count();
+  return stats;
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::OrderedQuery(
+    cas::SearchKey<VType>& key,
+    cas::BinaryKeyEmitter emitter,
+    cas::ValueOrder order,
+    size_t limit) {
+  cas::KeyEncoder<VType> encoder;
+  cas::BinarySK bkey;
+  if (use_surrogate_) {
+    std::vector<uint8_t> label;
+    encoder.Encode(key, bkey, surrogate_, label);
+    cas::SurrogatePathMatcher pm(surrogate_);
+    pm.Compile(bkey.path_);
+    cas::OrderedQuery<VType> query(bkey, pm, order);
+    query.AddIndex(root_);
+    query.Execute(std::move(emitter), limit);
+    return query.Stats();
+  } else {
+    encoder.Encode(key, bkey);
+    cas::PathMatcher pm;
+    pm.Compile(bkey.path_);
+    cas::OrderedQuery<VType> query(bkey, pm, order);
+    query.AddIndex(root_);
+    query.AddIndex(auxiliary_index_);
+    query.Execute(std::move(emitter), limit);
+    return query.Stats();
+  }
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::OrderedQuery(
+    cas::SearchKey<VType>& key,
+    cas::Emitter<VType> emitter,
+    cas::ValueOrder order,
+    size_t limit) {
+  cas::KeyDecoder<VType> decoder;
+  return OrderedQuery(key, [&](
         const std::vector<uint8_t>& buffer_path,
         const std::vector<uint8_t>& buffer_value,
         cas::did_t did) -> void {
@@ -253,21 +627,140 @@ const cas::QueryStats cas::Cas<VType>::Query(
     } else {
       emitter(decoder.Decode(buffer_path, buffer_value, did));
     }
+  }, order, limit);
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::BatchQuery(
+    std::vector<cas::SearchKey<VType>>& keys,
+    cas::TaggedBinaryKeyEmitter emitter) {
+  cas::KeyEncoder<VType> encoder;
+  std::vector<cas::BinarySK> bkeys(keys.size());
+  if (use_surrogate_) {
+    std::vector<uint8_t> label;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      encoder.Encode(keys[i], bkeys[i], surrogate_, label);
+    }
+    cas::SurrogatePathMatcher pm(surrogate_);
+    cas::BatchQuery<VType> query(root_, bkeys, pm, std::move(emitter));
+    query.Execute();
+    return query.Stats();
+  } else {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      encoder.Encode(keys[i], bkeys[i]);
+    }
+    cas::PathMatcher pm;
+    cas::BatchQuery<VType> query(root_, bkeys, pm, std::move(emitter));
+    query.setAuxiliaryIndex(auxiliary_index_);
+    query.Execute();
+    return query.Stats();
+  }
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::BatchQuery(
+    std::vector<cas::SearchKey<VType>>& keys,
+    cas::TaggedEmitter<VType> emitter) {
+  cas::KeyDecoder<VType> decoder;
+  return BatchQuery(keys, [&](
+        size_t query,
+        const std::vector<uint8_t>& buffer_path,
+        const std::vector<uint8_t>& buffer_value,
+        cas::did_t did) -> void {
+    if (use_surrogate_) {
+      emitter(query, decoder.Decode(surrogate_, buffer_path, buffer_value, did));
+    } else {
+      emitter(query, decoder.Decode(buffer_path, buffer_value, did));
+    }
   });
 }
 
 
 template<class VType>
-const cas::QueryStats cas::Cas<VType>::QueryRuntime(
+std::unique_ptr<cas::QueryCursor<VType>> cas::Cas<VType>::Cursor(
     cas::SearchKey<VType>& key) {
-  return Query(key, [&](
-        const std::vector<uint8_t>& /*buffer_path*/,
-        const std::vector<uint8_t>& /*buffer_value*/,
-        cas::did_t /*did*/) -> void {
+  return std::unique_ptr<cas::QueryCursor<VType>>(
+      new cas::QueryCursor<VType>(root_, auxiliary_index_, key,
+        use_surrogate_ ? &surrogate_ : nullptr));
+}
+
+
+template<class VType>
+std::unique_ptr<cas::PreparedQuery<VType>> cas::Cas<VType>::Prepare(
+    const cas::path_t& path) {
+  return std::unique_ptr<cas::PreparedQuery<VType>>(
+      new cas::PreparedQuery<VType>(path,
+        use_surrogate_ ? &surrogate_ : nullptr));
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::Query(
+    const cas::PreparedQuery<VType>& prepared,
+    const VType& low,
+    const VType& high,
+    cas::DidSpanEmitter emitter) {
+  cas::QueryContext::Lease lease = cas::QueryContext::Acquire();
+  return Execute(prepared, low, high, std::move(emitter), lease.Get());
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::Query(
+    const cas::PreparedQuery<VType>& prepared,
+    const VType& low,
+    const VType& high,
+    cas::BinaryKeyEmitter emitter) {
+  return Query(prepared, low, high, [&](
+        const std::vector<uint8_t>& buffer_path,
+        const std::vector<uint8_t>& buffer_value,
+        const cas::DidSpan& dids) -> void {
+    for (cas::did_t did : dids) {
+      emitter(buffer_path, buffer_value, did);
+    }
   });
 }
 
 
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::Query(
+    const cas::PreparedQuery<VType>& prepared,
+    const VType& low,
+    const VType& high,
+    cas::Emitter<VType> emitter) {
+  return Query(prepared, low, high, DecodingEmitter(emitter));
+}
+
+
+template<class VType>
+const cas::QueryStats cas::Cas<VType>::Execute(
+    const cas::PreparedQuery<VType>& prepared,
+    const VType& low,
+    const VType& high,
+    cas::DidSpanEmitter span_emitter,
+    cas::QueryContext& context) {
+  assert(prepared.getSurrogate() == (use_surrogate_ ? &surrogate_ : nullptr));
+  cas::QueryContext::Guard guard(context);
+  cas::KeyEncoder<VType> encoder;
+  cas::BinarySK& bkey = context.key_;
+  encoder.EncodeBounds(low, high, bkey);
+  cas::Query<VType> query(root_, bkey, prepared.Matcher(),
+      cas::BinaryKeyEmitter(), context);
+  query.setQueryPath(prepared.QueryPath());
+  query.setPrefetchDistance(prefetch_distance_);
+  query.setDidSpanEmitter(std::move(span_emitter));
+  if (!use_surrogate_) {
+    // like Query, the surrogate index only has a main index
+    query.setAuxiliaryIndex(auxiliary_index_);
+    query.setConcurrentAuxiliary(concurrent_auxiliary_query_);
+  }
+  query.Execute();
+  return query.Stats();
+}
+
+
 template<class VType>
 size_t cas::Cas<VType>::Size() {
   return nr_keys_;
@@ -280,6 +773,7 @@ const cas::IndexStats cas::Cas<VType>::Stats() {
   if (root_ != nullptr) {
     root_->CollectStats(stats, 0);
   }
+  allocator_.CollectStats(stats);
   stats.nr_keys_ = nr_keys_;
   return stats;
 }
@@ -291,6 +785,46 @@ void cas::Cas<VType>::setAuxiliaryIndex(Node *index) {
 }
 
 
+template<class VType>
+void cas::Cas<VType>::EnablePathSummary() {
+  if (use_surrogate_) {
+    return;
+  }
+  path_summary_.reset(new cas::PathSummary());
+  SummarizePaths(root_);
+  SummarizePaths(auxiliary_index_);
+}
+
+
+template<class VType>
+void cas::Cas<VType>::DisablePathSummary() {
+  path_summary_.reset();
+}
+
+
+template<class VType>
+void cas::Cas<VType>::SummarizePaths(cas::Node* root) {
+  if (root == nullptr) {
+    return;
+  }
+  // a query that matches every key: the bounds are longer than any
+  // value and the path is a single descendant-or-self step
+  cas::BinarySK bkey;
+  bkey.low_.assign(cas::kMaxValueLength+1, 0x00);
+  bkey.high_.assign(cas::kMaxValueLength+1, 0xFF);
+  bkey.path_.bytes_ = { cas::kByteDescendantOrSelf };
+  bkey.path_.types_ = { cas::ByteType::kTypeDescendant };
+  cas::PathMatcher pm;
+  pm.Compile(bkey.path_);
+  cas::QueryContext context;
+  cas::Query<VType> query(root, bkey, pm, cas::BinaryKeyEmitter(), context);
+  cas::Node0* leaf;
+  while ((leaf = query.NextLeaf()) != nullptr) {
+    path_summary_->Add(query.BufferPath(), leaf->dids_.size());
+  }
+}
+
+
 template<class VType>
 cas::Node* cas::Cas<VType>::getAuxiliaryIndex() {
     return auxiliary_index_;
@@ -306,6 +840,7 @@ void cas::Cas<VType>::mergeMainAndAuxiliaryIndex(cas::MergeMethod merge_method){
   did_t did_ = 0;
   std::stack<Node*> traversed_nodes_sec;
   cas::CasInsert<VType> casInsert_auxiliary(
+      allocator_,
       auxiliary_index_,
       bkey,
       pm,
@@ -364,22 +899,30 @@ void cas::Cas<VType>::Describe() {
   if (root_ != nullptr) {
     root_->CollectStats(stats, 0);
   }
+  allocator_.CollectStats(stats);
   std::cout << "Size (bytes): " << stats.size_bytes_ << std::endl;
   double bpk = nr_keys_ == 0 ? 0 :
       stats.size_bytes_ / static_cast<double>(nr_keys_);
   size_t internal_nodes = stats.nr_nodes_ - stats.nr_node0_;
   std::cout << "Bytes/Key:    " << bpk << std::endl;
+  double bpk_classic = nr_keys_ == 0 ? 0 :
+      stats.size_bytes_classic_ / static_cast<double>(nr_keys_);
+  std::cout << "Classic B/Key: " << bpk_classic << std::endl;
   std::cout << "Total Nodes:  " << stats.nr_nodes_ << std::endl;
   std::cout << "Inner Nodes:  " << internal_nodes << std::endl;
   std::cout << "Path Nodes:   " << stats.nr_path_nodes_ << std::endl;
   std::cout << "Value Nodes:  " << stats.nr_value_nodes_ << std::endl;
   std::cout << "Node0:        " << stats.nr_node0_ << std::endl;
   std::cout << "P-Node4:      " << stats.nr_p_node4_ << std::endl;
+  std::cout << "P-Node8:      " << stats.nr_p_node8_ << std::endl;
   std::cout << "P-Node16:     " << stats.nr_p_node16_ << std::endl;
+  std::cout << "P-Node32:     " << stats.nr_p_node32_ << std::endl;
   std::cout << "P-Node48:     " << stats.nr_p_node48_ << std::endl;
   std::cout << "P-Node256:    " << stats.nr_p_node256_ << std::endl;
   std::cout << "V-Node4:      " << stats.nr_v_node4_ << std::endl;
+  std::cout << "V-Node8:      " << stats.nr_v_node8_ << std::endl;
   std::cout << "V-Node16:     " << stats.nr_v_node16_ << std::endl;
+  std::cout << "V-Node32:     " << stats.nr_v_node32_ << std::endl;
   std::cout << "V-Node48:     " << stats.nr_v_node48_ << std::endl;
   std::cout << "V-Node256:    " << stats.nr_v_node256_ << std::endl;
   std::cout << "PP Steps:     " << stats.pp_steps << std::endl;
@@ -387,6 +930,18 @@ void cas::Cas<VType>::Describe() {
   std::cout << "PV Steps:     " << stats.pv_steps << std::endl;
   std::cout << "VP Steps:     " << stats.vp_steps << std::endl;
   std::cout << "Max Depth:    " << stats.max_depth_ << std::endl;
+  std::cout << "Alloc Slabs:  " << stats.alloc_slabs_ << std::endl;
+  std::cout << "Alloc Bytes:  " << stats.alloc_reserved_bytes_ << std::endl;
+  std::cout << "Alloc Live:   " << stats.alloc_live_bytes_ << std::endl;
+  std::cout << "Alloc Nodes:  " << stats.alloc_live_nodes_ << std::endl;
+  std::cout << "Alloc Free:   " << stats.alloc_free_nodes_ << std::endl;
+  std::cout << "Alloc Padding: " << stats.alloc_padding_bytes_ << std::endl;
+  std::cout << "Dispatch:     " << cas::NodeDispatch::Name() << std::endl;
+  std::cout << "Key search:   " << cas::KeySearch::Name() << std::endl;
+  std::cout << "Child Refs:   " << cas::ChildRefName() << std::endl;
+  std::cout << "Node Align:   " << cas::NodeAllocator::kInnerNodeAlign << std::endl;
+  std::cout << "Ref Bytes:    " << stats.child_ref_bytes_ << std::endl;
+  std::cout << "Ref Saved:    " << stats.child_ref_saved_bytes_ << std::endl;
   std::cout << "Surrogate:    " << (use_surrogate_ ? "yes" : "no") << std::endl;
   std::cout << "S. MaxDepth:  " << surrogate_.max_depth_ << std::endl;
   std::cout << "S. BytesPerLabel: " << surrogate_.bytes_per_label_ << std::endl;
@@ -2,6 +2,8 @@
 #include "cas/node_type.hpp"
 #include "cas/bulk_load.hpp"
 #include "cas/node0.hpp"
+#include "cas/node_dispatch.hpp"
+#include "cas/node_allocator.hpp"
 #include "cas/utils.hpp"
 #include <algorithm>
 #include <cassert>
@@ -11,11 +13,13 @@
 
 template<class VType>
 cas::CasDelete<VType>::CasDelete(
+        cas::NodeAllocator& allocator,
         cas::Node** root_main,
         cas::Node** root_auxiliary,
         const cas::BinaryKey& key,
         cas::UpdateType deletion_method)
-  : root_main_(root_main)
+  : allocator_(allocator)
+  , root_main_(root_main)
   , root_auxiliary_(root_auxiliary)
   , key_(key)
   , deletion_method_(deletion_method)
@@ -42,7 +46,11 @@ bool cas::CasDelete<VType>::Execute(cas::Node** root) {
   auto* leaf = static_cast<cas::Node0*>(node_);
 
   // delete DID from leaf node
-  DeleteDID(leaf->dids_, key_.did_);
+  nr_deleted_ = DeleteDID(leaf->dids_, key_.did_);
+  leaf->nr_keys_ -= nr_deleted_;
+  for (cas::Node* ancestor : ancestors_) {
+    ancestor->nr_keys_ -= nr_deleted_;
+  }
 
   // Case 1: check if there are more DIDs contained in the leaf
   if (!leaf->dids_.empty()) {
@@ -51,21 +59,22 @@ bool cas::CasDelete<VType>::Execute(cas::Node** root) {
 
   // Case *: check if the leaf to be deleted is the root node
   if (parent_ == nullptr) {
-    delete *root;
+    allocator_.Delete(*root);
     *root = nullptr;
     return true;
   }
 
   // delete the current leaf from the parent and the leaf itself
   parent_->DeleteNode(parent_byte_);
-  delete leaf;
+  allocator_.Delete(leaf);
 
   // Case 2: deleting the leaf does not require extensive restructuring
   if (parent_->nr_children_ > 1) {
     // the parent might become underfull (e.g., parent of type node48
     // should become a node16) and in this case we must shrink the parent
     if (parent_->IsUnderfilled()) {
-      cas::Node* new_parent = parent_->Shrink();
+      cas::Node* new_parent = parent_->Shrink(allocator_);
+      new_parent->nr_keys_ = parent_->nr_keys_;
       if (grand_parent_ == nullptr) {
         // the parent is the root node, hence we need to replace
         // the root node
@@ -75,7 +84,7 @@ bool cas::CasDelete<VType>::Execute(cas::Node** root) {
         // with the new_parent node
         grand_parent_->ReplaceBytePointer(grand_parent_byte_, new_parent);
       }
-      delete parent_;
+      allocator_.Delete(parent_);
       parent_ = new_parent;
     }
     PerformPrefixPullup();
@@ -132,7 +141,8 @@ void cas::CasDelete<VType>::PerformPrefixPullup() {
   }
 
   // add common prefix to the parent node's prefix
-  std::vector<uint8_t> parent_prefix;
+  cas::NodePrefix parent_prefix;
+  parent_prefix.reserve(parent_->prefix_.size() + dsc);
   std::copy(
       parent_->prefix_.begin(),
       parent_->prefix_.begin() + parent_->separator_pos_,
@@ -148,12 +158,13 @@ void cas::CasDelete<VType>::PerformPrefixPullup() {
   if (dimension == cas::NodeType::Value) {
     std::copy(ref_prefix, ref_prefix + dsc, std::back_inserter(parent_prefix));
   }
-  parent_->prefix_ = parent_prefix;
+  parent_->prefix_ = std::move(parent_prefix);
   parent_->separator_pos_ = parent_separator_pos;
 
   // remove common prefix from the children
   parent_->ForEachChild([&](uint8_t /* byte */, cas::Node& child) -> bool {
-    std::vector<uint8_t> prefix;
+    cas::NodePrefix prefix;
+    prefix.reserve(child.prefix_.size() - dsc);
     auto path_begin = child.prefix_.begin();
     if (dimension == cas::NodeType::Path) {
       path_begin = path_begin + dsc;
@@ -171,7 +182,7 @@ void cas::CasDelete<VType>::PerformPrefixPullup() {
         value_begin,
         child.prefix_.end(),
         std::back_inserter(prefix));
-    child.prefix_ = prefix;
+    child.prefix_ = std::move(prefix);
     child.separator_pos_ = separator_pos;
     return true;
   });
@@ -200,8 +211,8 @@ void cas::CasDelete<VType>::LazyDeletion(cas::Node** root) {
   cas::Node* child = parent_->LocateChild(next_byte);
 
   // combine common prefixes
-  std::vector<uint8_t> prefix;
-  prefix.reserve(parent_->prefix_.size() + node_->prefix_.size());
+  cas::NodePrefix prefix;
+  prefix.reserve(parent_->prefix_.size() + child->prefix_.size() + 1);
   uint16_t separator_pos = 0;
   // copy common path prefixes
   std::copy(
@@ -241,7 +252,7 @@ void cas::CasDelete<VType>::LazyDeletion(cas::Node** root) {
   } else {
     grand_parent_->ReplaceBytePointer(grand_parent_byte_, child);
   }
-  delete parent_;
+  allocator_.Delete(parent_);
 }
 
 
@@ -321,7 +332,7 @@ void cas::CasDelete<VType>::StrictDeletion(cas::Node** root) {
       ? cas::NodeType::Value
       : cas::NodeType::Path;
   }
-  cas::BulkLoad bulk_loader{keys, root_dimension};
+  cas::BulkLoad bulk_loader{allocator_, keys, root_dimension};
   cas::Node* new_parent = bulk_loader.Execute();
 
   // install new_parent in the tree
@@ -335,15 +346,15 @@ void cas::CasDelete<VType>::StrictDeletion(cas::Node** root) {
   }
 
   // delete old subtree recursively
-  std::function<void(cas::Node*)> DeleteSubtree = [&DeleteSubtree](cas::Node *node) {
+  std::function<void(cas::Node*)> DeleteSubtree = [&](cas::Node *node) {
     if (node == nullptr) {
       return;
     }
-    node->ForEachChild([&](uint8_t, cas::Node& child) -> bool {
+    cas::NodeDispatch::ForEachChild(node, [&](uint8_t, cas::Node& child) -> bool {
       DeleteSubtree(&child);
       return true;
     });
-    delete node;
+    allocator_.Delete(node);
   };
   DeleteSubtree(parent_);
 }
@@ -356,6 +367,7 @@ bool cas::CasDelete<VType>::Traverse(cas::Node** root) {
   grand_parent_ = nullptr;
   parent_byte_ = 0;
   grand_parent_byte_ = 0;
+  ancestors_.clear();
   uint8_t next_byte = 0x00;
 
   size_t g_p = 0;
@@ -418,7 +430,8 @@ bool cas::CasDelete<VType>::Traverse(cas::Node** root) {
     parent_byte_ = next_byte;
     grand_parent_ = parent_;
     parent_ = node_;
-    node_ = node_->LocateChild(next_byte);
+    ancestors_.push_back(node_);
+    node_ = cas::NodeDispatch::LocateChild(node_, next_byte);
   }
 
   return false;
@@ -426,15 +439,8 @@ bool cas::CasDelete<VType>::Traverse(cas::Node** root) {
 
 
 template<class VType>
-void cas::CasDelete<VType>::DeleteDID(std::vector<did_t>& v, cas::did_t did) {
-  size_t i = 0;
-  while (i < v.size()) {
-    if (v[i] == did) {
-      v.erase(v.begin() + i);
-    } else {
-      ++i;
-    }
-  }
+size_t cas::CasDelete<VType>::DeleteDID(cas::DidList& dids, cas::did_t did) {
+  return dids.Erase(did);
 }
 
 
@@ -1,5 +1,6 @@
 #include "cas/cas_insert.hpp"
 #include "cas/node0.hpp"
+#include "cas/node_dispatch.hpp"
 #include <cas/node4.hpp>
 #include <cas/node16.hpp>
 #include <cas/node48.hpp>
@@ -14,14 +15,16 @@
 
 
 template<class VType>
-cas::CasInsert<VType>::CasInsert(cas::Node* root,
+cas::CasInsert<VType>::CasInsert(cas::NodeAllocator& allocator,
+        cas::Node* root,
         cas::BinarySK& key,
         cas::InsertionHelper& pm,
         cas::did_t did,
         cas::Node* second_index,
         bool isMain,
         cas::MergeMethod merge_method)
-  : root_(root)
+  : allocator_(allocator)
+  , root_(root)
   , parent_(nullptr)
   , grand_parent_(nullptr)
   , key_(key)
@@ -37,11 +40,10 @@ cas::CasInsert<VType>::CasInsert(cas::Node* root,
 template<class VType>
 bool cas::CasInsert<VType>::Execute(cas::Node*& root_node, cas::UpdateType insertType, cas::Node*& root_node_sec) {
   if (root_node == nullptr) {
-    root_node = new Node0();
+    root_node = allocator_.New<cas::Node0>();
     cas::Node0 * currNode = static_cast<Node0 *>(root_node);
     currNode->nr_keys_ = 1;
     currNode->separator_pos_ = key_.path_.Size();
-    currNode->dids_.reserve(1);
     currNode->dids_.push_back(did_);
     currNode->prefix_= key_.path_.bytes_;
     currNode->prefix_.insert(currNode->prefix_.end(), key_.low_.begin(), key_.low_.end());
@@ -113,7 +115,6 @@ bool cas::CasInsert<VType>::Execute(cas::Node*& root_node, cas::UpdateType inser
   /*line 24*/    if ((s.pm_state_.qpos_ >= key_.path_.bytes_.size()) && (s.vl_pos_ >= key_.low_.size())) {
     cas::Node0 * currNode =  static_cast<Node0 *>(s.node_);
     currNode->dids_.push_back(did_);
-    currNode->dids_.shrink_to_fit();
     while(!traversed_nodes_.empty()){
       cas::Node *node =  traversed_nodes_.top();
       node->nr_keys_ += 1;
@@ -126,7 +127,7 @@ bool cas::CasInsert<VType>::Execute(cas::Node*& root_node, cas::UpdateType inser
   }
   //Insertion Case 2 - Insertion of a new leaf node
   /*line 26*/    else if (s.node_ == nullptr){
-    cas::Node0* leaf = new Node0();
+    cas::Node0* leaf = allocator_.New<cas::Node0>();
 
     BinaryKey bk;
     bk.path_ = key_.path_.bytes_;
@@ -135,7 +136,7 @@ bool cas::CasInsert<VType>::Execute(cas::Node*& root_node, cas::UpdateType inser
 
     std::deque<cas::BinaryKey> keys;
     keys.push_front(bk);
-    cas::BulkLoad add_Leaf(keys, parent_->type_ == cas::NodeType::Path ? cas::NodeType::Path : cas::NodeType::Value);
+    cas::BulkLoad add_Leaf(allocator_, keys, parent_->type_ == cas::NodeType::Path ? cas::NodeType::Path : cas::NodeType::Value);
 
     // Make a decision where to increase
     uint16_t path_pos = s.pm_state_.qpos_;
@@ -148,19 +149,14 @@ bool cas::CasInsert<VType>::Execute(cas::Node*& root_node, cas::UpdateType inser
     }
 
     add_Leaf.BuildPrefix(leaf, bk, path_pos, val_pos, bk.Get(cas::NodeType::Path).size(), bk.Get(cas::NodeType::Value).size());
-    leaf->dids_.reserve(1);
     leaf->dids_.push_back(did_);
     leaf->nr_keys_ = 1;
     uint8_t key_byte = bk.Get(parent_->type_)[parent_->type_ == cas::NodeType::Path ? s.pm_state_.qpos_ : s.vl_pos_];
 
 
     //Does node need to grow check
-    //Since the pointer is of the Base class, I don't know which derived class is my current node, Node4 or Node16 ...
-    //The easiest way is to just check end values when grow needs to be done
-    //*** Possibly will have to change when Delete of keys is added, so the nodes can shrink
-
-    if (parent_->nr_children_ == 4 || parent_->nr_children_ == 16 || parent_->nr_children_ == 48 ){
-      Node* extended_parent = parent_->Grow();
+    if (parent_->IsFull()) {
+      Node* extended_parent = parent_->Grow(allocator_);
       extended_parent->nr_keys_ = parent_->nr_keys_;
 
       // if the grown node wasn't the root node then we should replace byte pointer in his parent, otherwise root node does not have a parent (i.e. grandparent of the current node) so the replace cannot be done
@@ -170,7 +166,7 @@ bool cas::CasInsert<VType>::Execute(cas::Node*& root_node, cas::UpdateType inser
       }else{
         root_node = extended_parent;
       }
-      delete parent_;
+      allocator_.Delete(parent_);
       parent_ = extended_parent;
 
     }
@@ -324,22 +320,22 @@ void cas::CasInsert<VType>::StrictSlowInsertion(State& s, uint16_t next_node_qpo
 
   cas::NodeType s_node_type_ = s.node_->type_;
   CollectSubtreeKeys(bkeys_, s.node_, path_prefix_, value_prefix_, leaf_counter);
-  cas::Cas<VType>* subtree = new Cas<VType>(cas::IndexType::TwoDimensional, {});
+  cas::Node* subtree_root;
 
   if(s_node_type_ == cas::NodeType::Leaf){
     // If we want to keep alternation of dimensions we have to do BulkLoad with the alternating NodeType compared to the node parent
-    subtree->BulkLoad(bkeys_, s.parent_type_ == cas::NodeType::Path ? cas::NodeType::Value : cas::NodeType::Path);
+    subtree_root = cas::BulkLoad(allocator_, bkeys_, s.parent_type_ == cas::NodeType::Path ? cas::NodeType::Value : cas::NodeType::Path).Execute();
   }else{
     // We need this check, because we want to keep the alternation of dimensions in the index
     // For example, in the bom.csv index, if we have mismatch in the node 03D3, r/battery$, V and we partition by n.D, that is. V
     // we will lose alternation of the dimensions since the parent of node also has dimension V. The dimension in the node is V since we cannot partition in P but when we add the new node this may change so the
     // partition in the alternating dimension is possible. If the partition is still not possible in the specified dimension, this will be automatically adjusted by the BulkLoad algorithm
     if(s.parent_type_ == cas::NodeType::Path && parent_ != nullptr){
-      subtree->BulkLoad(bkeys_, cas::NodeType::Value);
+      subtree_root = cas::BulkLoad(allocator_, bkeys_, cas::NodeType::Value).Execute();
     }else if(s.parent_type_ == cas::NodeType::Value && parent_ != nullptr){
-      subtree->BulkLoad(bkeys_, cas::NodeType::Path);
+      subtree_root = cas::BulkLoad(allocator_, bkeys_, cas::NodeType::Path).Execute();
     }else {
-      subtree->BulkLoad(bkeys_, cas::NodeType::Value);
+      subtree_root = cas::BulkLoad(allocator_, bkeys_, cas::NodeType::Value).Execute();
     }
   }
 
@@ -347,22 +343,20 @@ void cas::CasInsert<VType>::StrictSlowInsertion(State& s, uint16_t next_node_qpo
   // This should be done only if the root_ of the subtree does not become the root_ of the whole tree, that is when the parent_ node is not null
   // If the discriminative byte is the Path byte then we have to shrink the separator position since we remove the first element of the prefix as a discriminative byte
   if (s.parent_type_ == cas::NodeType::Path && parent_ != nullptr) {
-    subtree->root_->prefix_.erase(subtree->root_->prefix_.begin());
-    subtree->root_->separator_pos_--;
+    subtree_root->prefix_.erase(subtree_root->prefix_.begin());
+    subtree_root->separator_pos_--;
   }
   else if (s.parent_type_ == cas::NodeType::Value && parent_ != nullptr){
-    subtree->root_->prefix_.erase(subtree->root_->prefix_.begin()+subtree->root_->separator_pos_);
+    subtree_root->prefix_.erase(subtree_root->prefix_.begin()+subtree_root->separator_pos_);
   }
-  subtree->root_->prefix_.shrink_to_fit();
+  subtree_root->prefix_.shrink_to_fit();
 
   // Parent can only be null if the mismatch occurred in the root node, so the root node is replaced with the new subtree
   if(parent_ == nullptr){
-    root_ = subtree->root_;
+    root_ = subtree_root;
   }else{
-    parent_->ReplaceBytePointer(s.parent_byte_, subtree->root_);
+    parent_->ReplaceBytePointer(s.parent_byte_, subtree_root);
   }
-  subtree->root_ = nullptr;
-  delete subtree;
 }
 
 template<class VType>
@@ -407,7 +401,7 @@ void cas::CasInsert<VType>::LazyFastInsertion(State &s, uint16_t next_node_qpos_
   uint16_t iv = s.vl_pos_ - next_node_vl_pos_;
 
   // New parent node of n
-  Node4* np_prim = new Node4(DetermineDimension(s, s.pm_state_.ppos_, s.vl_pos_));
+  Node4* np_prim = allocator_.New<cas::Node4>(DetermineDimension(s, s.pm_state_.ppos_, s.vl_pos_));
   uint8_t np_prim_disc_byte;
 
   std::vector<uint8_t> np_prim_path_;
@@ -479,7 +473,7 @@ void cas::CasInsert<VType>::LazyFastInsertion(State &s, uint16_t next_node_qpos_
   s.node_->prefix_ = new_curr_node_prefix_;
 
   //New sibling node of n
-  Node0* node_sibling = new Node0();
+  Node0* node_sibling = allocator_.New<cas::Node0>();
   uint8_t node_sibling_disc_byte;
   node_sibling->nr_keys_ = 1;
 
@@ -538,20 +532,20 @@ void cas::CasInsert<VType>::CollectSubtreeKeys(std::deque<cas::BinaryKey>& bkeys
   if(node->nr_children_ == 0){
     cas::Node0* leaf_Node = static_cast<cas::Node0 *> (node);
 
-    for (size_t n = 0; n < leaf_Node->dids_.size(); n++) {
+    for (cas::did_t did : leaf_Node->dids_) {
       BinaryKey bk;
       bk.path_ = path_prefix_;
       bk.value_ = value_prefix_;
-      bk.did_ = leaf_Node->dids_[n];
+      bk.did_ = did;
       bkeys_.push_back(bk);
       leaf_counter++;
     }
-    delete node;
+    allocator_.Delete(node);
     node = nullptr;
   }
   //Current node has children
   else{
-    node->ForEachChild([&](uint8_t byte, cas::Node& child) -> bool {
+    cas::NodeDispatch::ForEachChild(node, [&](uint8_t byte, cas::Node& child) -> bool {
         std::vector<uint8_t> curr_path_prefix_(path_prefix_);
         std::vector<uint8_t> curr_value_prefix_(value_prefix_);
 
@@ -582,7 +576,7 @@ void cas::CasInsert<VType>::CollectSubtreeKeys(std::deque<cas::BinaryKey>& bkeys
         CollectSubtreeKeys(bkeys_, &child, curr_path_prefix_, curr_value_prefix_, leaf_counter);
         return true;
     });
-    delete node;
+    allocator_.Delete(node);
     node = nullptr;
   }
   return;
@@ -670,8 +664,8 @@ void cas::CasInsert<VType>::mergeIndexes(
           //If we do an insert by first looking at whether we can insert a key into the Main index, we will never enter in Auxiliary index here, because the key as a new Leaf node could already have been inserted into the Main index
           else{
           // node_sec in the main index should be expanded
-          if (node_sec->nr_children_ == 4 || node_sec->nr_children_ == 16 || node_sec->nr_children_ == 48){
-          Node* extended_parent = node_sec->Grow();
+          if (node_sec->IsFull()) {
+          Node* extended_parent = node_sec->Grow(allocator_);
           extended_parent->nr_keys_ = node_sec->nr_keys_;
 
           // if the grown node wasn't the root node then we should replace byte pointer in his parent, otherwise root node does not have a parent (i.e. grandparent of the current node) so the replace cannot be done
@@ -681,8 +675,11 @@ void cas::CasInsert<VType>::mergeIndexes(
           }else{
           second_index_ = extended_parent;
           }
-          delete node_sec;
+          allocator_.Delete(node_sec);
           node_sec = extended_parent;
+          // the recursive calls for the next children must not see the deleted node
+          traversed_nodes_sec.pop();
+          traversed_nodes_sec.push(node_sec);
           }
 
           node_sec->Put(byte, &child);
@@ -695,16 +692,18 @@ void cas::CasInsert<VType>::mergeIndexes(
 
           //Update nr_keys in the subtree
           //remove node_sec where the mismatch occurred
-          if(!traversed_nodes_sec.empty()) traversed_nodes_sec.pop();
-          while(!traversed_nodes_sec.empty()){
-            cas::Node *node =  traversed_nodes_sec.top();
+          //the stack is copied since the next children of node_prim need it as well
+          std::stack<cas::Node*> ancestors_sec = traversed_nodes_sec;
+          if(!ancestors_sec.empty()) ancestors_sec.pop();
+          while(!ancestors_sec.empty()){
+            cas::Node *node =  ancestors_sec.top();
             node->nr_keys_  = node->nr_keys_ + child.nr_keys_;
-            traversed_nodes_sec.pop();
+            ancestors_sec.pop();
           }
           }
           return true;
       });
-      delete node_prim;
+      allocator_.Delete(node_prim);
       node_prim = nullptr;
     }
   }
@@ -803,22 +802,22 @@ void cas::CasInsert<VType>::collectMainAndAuxIndexAndRebuildSubtree(cas::Node *n
   CollectSubtreeKeys(bkeys_, node_sec, path_prefix_sec, value_prefix_sec, leaf_counter_sec);
 
 
-  cas::Cas<VType>* subtree = new Cas<VType>(cas::IndexType::TwoDimensional, {});
+  cas::Node* subtree_root;
 
   if(node_type_sec == cas::NodeType::Leaf){
     // If we want to keep alternation of dimensions we have to do BulkLoad with the alternating NodeType compared to the node parent
-    subtree->BulkLoad(bkeys_, parent_type_sec == cas::NodeType::Path ? cas::NodeType::Value : cas::NodeType::Path);
+    subtree_root = cas::BulkLoad(allocator_, bkeys_, parent_type_sec == cas::NodeType::Path ? cas::NodeType::Value : cas::NodeType::Path).Execute();
   }else{
     // We need this check, because we want to keep the alternation of dimensions in the index
     // For example, in the bom.csv index, if we have mismatch in the node 03D3, r/battery$, V and we partition by n.D, that is. V
     // we will lose alternation of the dimensions since the parent of node also has dimension V. The dimension in the node is V since we cannot partition in P but when we add the new node this may change so the
     // partition in the alternating dimension is possible. If the partition is still not possible in the specified dimension, this will be automatically adjusted by the BulkLoad algorithm
     if(parent_type_sec == cas::NodeType::Path /*&& s.node_->type_ == cas::NodeType::Path*/ && parent_node_sec != nullptr){
-      subtree->BulkLoad(bkeys_, cas::NodeType::Value);
+      subtree_root = cas::BulkLoad(allocator_, bkeys_, cas::NodeType::Value).Execute();
     }else if(parent_type_sec == cas::NodeType::Value /*&& s.node_->type_ == cas::NodeType::Value*/ && parent_node_sec != nullptr){
-      subtree->BulkLoad(bkeys_, cas::NodeType::Path);
+      subtree_root = cas::BulkLoad(allocator_, bkeys_, cas::NodeType::Path).Execute();
     }else {
-      subtree->BulkLoad(bkeys_, cas::NodeType::Value);
+      subtree_root = cas::BulkLoad(allocator_, bkeys_, cas::NodeType::Value).Execute();
     }
   }
 
@@ -826,29 +825,29 @@ void cas::CasInsert<VType>::collectMainAndAuxIndexAndRebuildSubtree(cas::Node *n
   // This should be done only if the root_ of the subtree does not become the root_ of the whole tree, that is when the parent_ node is not null
   // If the discriminative byte is the Path byte then we have to shrink the separator position since we remove the first element of the prefix as a discriminative byte
   if (parent_type_sec == cas::NodeType::Path && parent_node_sec != nullptr) {
-    subtree->root_->prefix_.erase(subtree->root_->prefix_.begin());
-    subtree->root_->separator_pos_--;
+    subtree_root->prefix_.erase(subtree_root->prefix_.begin());
+    subtree_root->separator_pos_--;
   }
   else if (parent_type_sec == cas::NodeType::Value && parent_node_sec != nullptr){
-    subtree->root_->prefix_.erase(subtree->root_->prefix_.begin()+subtree->root_->separator_pos_);
+    subtree_root->prefix_.erase(subtree_root->prefix_.begin()+subtree_root->separator_pos_);
   }
-  subtree->root_->prefix_.shrink_to_fit();
+  subtree_root->prefix_.shrink_to_fit();
 
   // Parent can only be null if the mismatch occurred in the root node, so the root node is replaced with the new subtree
   if(parent_node_sec == nullptr){
-    second_index_ = subtree->root_;
+    second_index_ = subtree_root;
   }else{
-    parent_node_sec->ReplaceBytePointer(parent_byte_sec, subtree->root_);
+    parent_node_sec->ReplaceBytePointer(parent_byte_sec, subtree_root);
 
     //Update nr_keys in the subtree
     //remove node_sec where the mismatch occured
     if(!traversed_nodes_sec.empty()) { traversed_nodes_sec.pop(); }
     //
-    size_t nr_keys_difference_sec = subtree->root_->nr_keys_ - node_sec_nr_keys;
+    size_t nr_keys_difference_sec = subtree_root->nr_keys_ - node_sec_nr_keys;
     //
     while(!traversed_nodes_sec.empty()){
       cas::Node *node =  traversed_nodes_sec.top();
-      node->nr_keys_  = node->nr_keys_ + (subtree->root_->nr_keys_ - node_sec_nr_keys);
+      node->nr_keys_  = node->nr_keys_ + (subtree_root->nr_keys_ - node_sec_nr_keys);
       traversed_nodes_sec.pop();
     }
   }
@@ -859,8 +858,6 @@ void cas::CasInsert<VType>::collectMainAndAuxIndexAndRebuildSubtree(cas::Node *n
     root_ = nullptr;
   }
 
-  subtree->root_ = nullptr;
-  delete subtree;
 }
 
 
@@ -869,11 +866,11 @@ void cas::CasInsert<VType>::DeleteTreeNodesRecursively(cas::Node *node, int& del
   if (node == nullptr) {
     return;
   }
-  node->ForEachChild([&](uint8_t, cas::Node& child) -> bool {
+  cas::NodeDispatch::ForEachChild(node, [&](uint8_t, cas::Node& child) -> bool {
       DeleteTreeNodesRecursively(&child, delete_counter);
       return true;
       });
-  delete node;
+  allocator_.Delete(node);
   node = nullptr;
   delete_counter++;
 }
@@ -967,7 +964,7 @@ void cas::CasInsert<VType>::DescendPathNode(State& s) {
   // we are looking for exactly one child
   uint8_t byte = key_.path_.bytes_[s.pm_state_.qpos_];
 
-  cas::Node* child = s.node_->LocateChild(byte);
+  cas::Node* child = cas::NodeDispatch::LocateChild(s.node_, byte);
   if (child != nullptr) {
 
     stack_.push_back({
@@ -991,7 +988,8 @@ void cas::CasInsert<VType>::DescendValueNode(State& s) {
   uint8_t low  = (s.vl_pos_ == s.len_val_) ? key_.low_[s.vl_pos_]  : 0x00;
   uint8_t high = (s.vh_pos_ == s.len_val_) ? key_.high_[s.vh_pos_] : 0xFF;
 
-  s.node_->ForEachChild(low, high, [&](uint8_t byte, cas::Node& child) -> bool {
+  cas::NodeDispatch::ForEachChild(s.node_, low, high,
+      [&](uint8_t byte, cas::Node& child) -> bool {
       stack_.push_back({
           .node_        = &child,
           .parent_type_ = s.node_->type_,
@@ -27,6 +27,7 @@ cas::QueryStats cas::CasSeq<VType>::Insert(
     cas::InsertTarget insert_target) {
   cas::KeyEncoder<VType> encoder;
   data_.push_back(encoder.Encode(key));
+  return cas::QueryStats();
 }
 
 
@@ -44,11 +45,25 @@ uint64_t cas::CasSeq<VType>::BulkLoad(std::deque<cas::Key<VType>>& keys) {
 template<class VType>
 const cas::QueryStats cas::CasSeq<VType>::Query(cas::SearchKey<VType>& skey,
     cas::BinaryKeyEmitter emitter) {
+  return Query(skey, [&](
+        const std::vector<uint8_t>& buffer_path,
+        const std::vector<uint8_t>& buffer_value,
+        const cas::DidSpan& dids) -> void {
+    emitter(buffer_path, buffer_value, *dids.begin());
+  });
+}
+
+
+template<class VType>
+const cas::QueryStats cas::CasSeq<VType>::Query(cas::SearchKey<VType>& skey,
+    cas::DidSpanEmitter emitter) {
   cas::QueryStats stats;
   const auto& t_start = std::chrono::high_resolution_clock::now();
 
   cas::KeyEncoder<VType> encoder;
   cas::BinarySK bskey = encoder.Encode(skey);
+  cas::PathMatcher pm;
+  pm.Compile(bskey.path_);
 
   for (const auto& key : data_) {
     // Possible improvement: evaluate path predicate only if the value
@@ -59,11 +74,11 @@ const cas::QueryStats cas::CasSeq<VType>::Query(cas::SearchKey<VType>& skey,
     // because the higher the selectivity of the value predicate the more
     // often the path predicate has to be evaluated
     bool match_val = MatchesValue(bskey, key);
-    bool match_pat = MatchesPath(bskey, key);
+    bool match_pat = MatchesPath(pm, bskey, key);
 
     if (match_val && match_pat) {
       ++stats.nr_matches_;
-      emitter(key.path_, key.value_, key.did_);
+      emitter(key.path_, key.value_, cas::DidSpan(&key.did_, 1));
     }
   }
 
@@ -93,7 +108,7 @@ const cas::QueryStats cas::CasSeq<VType>::QueryRuntime(
   return Query(skey, [&](
         const std::vector<uint8_t>& /*buffer_path*/,
         const std::vector<uint8_t>& /*buffer_value*/,
-        cas::did_t /*did*/) -> void {
+        const cas::DidSpan& /*dids*/) -> void {
   });
 }
 
@@ -108,9 +123,8 @@ bool cas::CasSeq<VType>::MatchesValue(const cas::BinarySK& skey,
 
 
 template<class VType>
-bool cas::CasSeq<VType>::MatchesPath(const cas::BinarySK& skey,
-    const cas::BinaryKey& key) {
-  cas::PathMatcher pm;
+bool cas::CasSeq<VType>::MatchesPath(cas::PathMatcher& pm,
+    const cas::BinarySK& skey, const cas::BinaryKey& key) {
   return pm.MatchPath(key.path_, skey.path_);
 }
 
@@ -0,0 +1,285 @@
+#include "cas/did_list.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+
+namespace {
+
+size_t VarintSize(cas::did_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+} // namespace
+
+
+cas::DidList::DidList() {
+  inline_[0] = 0;
+  inline_[1] = 0;
+}
+
+
+cas::DidList::DidList(const cas::DidList& other) : DidList() {
+  *this = other;
+}
+
+
+cas::DidList::DidList(cas::DidList&& other) : DidList() {
+  *this = std::move(other);
+}
+
+
+cas::DidList::~DidList() {
+  clear();
+}
+
+
+cas::DidList& cas::DidList::operator=(const cas::DidList& other) {
+  if (this != &other) {
+    Assign(other.ToVector());
+  }
+  return *this;
+}
+
+
+cas::DidList& cas::DidList::operator=(cas::DidList&& other) {
+  if (this != &other) {
+    clear();
+    size_ = other.size_;
+    nr_bytes_ = other.nr_bytes_;
+    capacity_ = other.capacity_;
+    std::memcpy(&encoded_, &other.encoded_, sizeof(encoded_));
+    other.size_ = 0;
+    other.nr_bytes_ = 0;
+    other.capacity_ = 0;
+  }
+  return *this;
+}
+
+
+void cas::DidList::push_back(cas::did_t did) {
+  if (IsInline()) {
+    if (size_ < kInlineDids) {
+      size_t pos = size_;
+      while (pos > 0 && inline_[pos-1] > did) {
+        inline_[pos] = inline_[pos-1];
+        --pos;
+      }
+      inline_[pos] = did;
+      ++size_;
+      return;
+    }
+    Reserve(16);
+  }
+  if (did >= encoded_.last_) {
+    // common case: DIDs arrive in increasing order
+    AppendVarint(did - encoded_.last_);
+    encoded_.last_ = did;
+    ++size_;
+    return;
+  }
+  // find the first DID that is larger than did and split its delta
+  const uint8_t* pos = encoded_.bytes_;
+  cas::did_t previous = 0;
+  cas::did_t current = 0;
+  size_t offset;
+  while (true) {
+    offset = pos - encoded_.bytes_;
+    current = previous + DecodeVarint(pos);
+    if (current > did) {
+      break;
+    }
+    previous = current;
+  }
+  uint8_t deltas[2 * kMaxVarintBytes];
+  size_t nr_bytes = WriteVarint(deltas, did - previous);
+  nr_bytes += WriteVarint(deltas + nr_bytes, current - did);
+  Splice(offset, pos - encoded_.bytes_, deltas, nr_bytes);
+  ++size_;
+}
+
+
+void cas::DidList::shrink_to_fit() {
+  if (!IsInline() && nr_bytes_ < capacity_) {
+    uint8_t* bytes = new uint8_t[nr_bytes_];
+    std::memcpy(bytes, encoded_.bytes_, nr_bytes_);
+    delete[] encoded_.bytes_;
+    encoded_.bytes_ = bytes;
+    capacity_ = nr_bytes_;
+  }
+}
+
+
+void cas::DidList::clear() {
+  if (!IsInline()) {
+    delete[] encoded_.bytes_;
+  }
+  size_ = 0;
+  nr_bytes_ = 0;
+  capacity_ = 0;
+}
+
+
+bool cas::DidList::Contains(cas::did_t did) const {
+  for (auto it = begin(); it != end(); ++it) {
+    if (*it >= did) {
+      return *it == did;
+    }
+  }
+  return false;
+}
+
+
+size_t cas::DidList::Erase(cas::did_t did) {
+  if (IsInline()) {
+    size_t nr_kept = 0;
+    for (size_t i = 0; i < size_; ++i) {
+      if (inline_[i] != did) {
+        inline_[nr_kept++] = inline_[i];
+      }
+    }
+    size_t nr_erased = size_ - nr_kept;
+    size_ = nr_kept;
+    return nr_erased;
+  }
+  // find the run of did, i.e., its first occurrence followed by the
+  // zero deltas of its copies
+  const uint8_t* pos = encoded_.bytes_;
+  const uint8_t* bytes_end = encoded_.bytes_ + nr_bytes_;
+  cas::did_t previous = 0;
+  size_t run_begin = 0;
+  size_t nr_erased = 0;
+  bool run_at_end = true;
+  while (pos < bytes_end) {
+    const uint8_t* element = pos;
+    cas::did_t current = (nr_erased > 0 ? did : previous) + DecodeVarint(pos);
+    if (current < did) {
+      previous = current;
+      continue;
+    }
+    if (current > did) {
+      if (nr_erased == 0) {
+        return 0;
+      }
+      // re-encode the next DID relative to the DID before the run
+      uint8_t delta[kMaxVarintBytes];
+      size_t nr_bytes = WriteVarint(delta, current - previous);
+      Splice(run_begin, pos - encoded_.bytes_, delta, nr_bytes);
+      run_at_end = false;
+      break;
+    }
+    if (nr_erased == 0) {
+      run_begin = element - encoded_.bytes_;
+    }
+    ++nr_erased;
+  }
+  if (nr_erased == 0) {
+    return 0;
+  }
+  if (run_at_end) {
+    nr_bytes_ = run_begin;
+    encoded_.last_ = previous;
+  }
+  size_ -= nr_erased;
+  if (size_ <= kInlineDids) {
+    cas::did_t dids[kInlineDids];
+    std::copy(begin(), end(), dids);
+    size_t size = size_;
+    clear();
+    std::copy(dids, dids + size, inline_);
+    size_ = size;
+  }
+  return nr_erased;
+}
+
+
+void cas::DidList::Assign(const std::vector<cas::did_t>& sorted_dids) {
+  assert(std::is_sorted(sorted_dids.begin(), sorted_dids.end()));
+  clear();
+  if (sorted_dids.size() <= kInlineDids) {
+    std::copy(sorted_dids.begin(), sorted_dids.end(), inline_);
+    size_ = sorted_dids.size();
+    return;
+  }
+  size_t nr_bytes = 0;
+  cas::did_t previous = 0;
+  for (cas::did_t did : sorted_dids) {
+    nr_bytes += VarintSize(did - previous);
+    previous = did;
+  }
+  encoded_.last_ = 0;
+  Reserve(nr_bytes);
+  for (cas::did_t did : sorted_dids) {
+    AppendVarint(did - encoded_.last_);
+    encoded_.last_ = did;
+  }
+  size_ = sorted_dids.size();
+}
+
+
+void cas::DidList::Reserve(size_t nr_bytes) {
+  if (nr_bytes <= capacity_) {
+    return;
+  }
+  assert(nr_bytes <= std::numeric_limits<uint32_t>::max());
+  uint8_t* bytes = new uint8_t[nr_bytes];
+  if (IsInline()) {
+    // the inline DIDs must be encoded into the new buffer
+    std::vector<cas::did_t> dids = ToVector();
+    encoded_.bytes_ = bytes;
+    encoded_.last_ = 0;
+    capacity_ = nr_bytes;
+    nr_bytes_ = 0;
+    for (cas::did_t did : dids) {
+      AppendVarint(did - encoded_.last_);
+      encoded_.last_ = did;
+    }
+    return;
+  }
+  std::memcpy(bytes, encoded_.bytes_, nr_bytes_);
+  delete[] encoded_.bytes_;
+  encoded_.bytes_ = bytes;
+  capacity_ = nr_bytes;
+}
+
+
+void cas::DidList::Splice(size_t begin, size_t end,
+    const uint8_t* bytes, size_t nr_bytes) {
+  size_t new_nr_bytes = nr_bytes_ - (end - begin) + nr_bytes;
+  if (new_nr_bytes > capacity_) {
+    Reserve(std::max<size_t>(2 * capacity_, new_nr_bytes));
+  }
+  std::memmove(encoded_.bytes_ + begin + nr_bytes, encoded_.bytes_ + end,
+      nr_bytes_ - end);
+  std::memcpy(encoded_.bytes_ + begin, bytes, nr_bytes);
+  nr_bytes_ = new_nr_bytes;
+}
+
+
+size_t cas::DidList::WriteVarint(uint8_t* out, cas::did_t value) {
+  size_t nr_bytes = 0;
+  while (value >= 0x80) {
+    out[nr_bytes++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  out[nr_bytes++] = static_cast<uint8_t>(value);
+  return nr_bytes;
+}
+
+
+void cas::DidList::AppendVarint(cas::did_t value) {
+  if (nr_bytes_ + VarintSize(value) > capacity_) {
+    Reserve(std::max<size_t>(2 * capacity_, nr_bytes_ + 16));
+  }
+  while (value >= 0x80) {
+    encoded_.bytes_[nr_bytes_++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  encoded_.bytes_[nr_bytes_++] = static_cast<uint8_t>(value);
+}
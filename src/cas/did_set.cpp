@@ -0,0 +1,56 @@
+#include "cas/did_set.hpp"
+#include <algorithm>
+
+
+cas::DidSet::DidSet(std::vector<cas::did_t>&& dids)
+    : dids_(std::move(dids))
+{
+  std::sort(dids_.begin(), dids_.end());
+  dids_.erase(std::unique(dids_.begin(), dids_.end()), dids_.end());
+  if (dids_.empty()) {
+    return;
+  }
+  size_ = dids_.size();
+  min_ = dids_.front();
+  max_ = dids_.back();
+  // a bitmap takes one bit per DID in the range, the vector 64
+  did_t range = max_ - min_;
+  if (range / 64 < dids_.size()) {
+    bitmap_.assign(range / 64 + 1, 0);
+    for (cas::did_t did : dids_) {
+      did_t bit = did - min_;
+      bitmap_[bit / 64] |= uint64_t{1} << (bit % 64);
+    }
+    dids_.clear();
+    dids_.shrink_to_fit();
+  }
+}
+
+
+std::vector<cas::did_t> cas::DidSet::Dids() const {
+  if (!IsBitmap()) {
+    return dids_;
+  }
+  std::vector<cas::did_t> dids;
+  dids.reserve(size_);
+  for (size_t word = 0; word < bitmap_.size(); ++word) {
+    uint64_t bits = bitmap_[word];
+    while (bits != 0) {
+      dids.push_back(min_ + word * 64 + __builtin_ctzll(bits));
+      bits &= bits - 1;
+    }
+  }
+  return dids;
+}
+
+
+bool cas::DidSet::Contains(cas::did_t did) const {
+  if (size_ == 0 || did < min_ || did > max_) {
+    return false;
+  }
+  if (IsBitmap()) {
+    did_t bit = did - min_;
+    return (bitmap_[bit / 64] >> (bit % 64)) & 1;
+  }
+  return std::binary_search(dids_.begin(), dids_.end(), did);
+}
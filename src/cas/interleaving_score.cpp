@@ -3,6 +3,7 @@
 #include "cas/interleaved_key.hpp"
 #include "cas/interleaver.hpp"
 #include "cas/node0.hpp"
+#include "cas/node_dispatch.hpp"
 
 #include <iostream>
 #include <cassert>
@@ -41,7 +42,7 @@ double cas::InterleavingScore<VType>::Compute() {
 
 template<class VType>
 void cas::InterleavingScore<VType>::Descend(State& s) {
-  s.node_->ForEachChild([&](uint8_t /*byte*/, cas::Node& child) -> bool {
+  cas::NodeDispatch::ForEachChild(s.node_, [&](uint8_t /*byte*/, cas::Node& child) -> bool {
     State child_s = {
       .node_        = &child,
       .depth_       = s.depth_ + 1,
@@ -117,14 +117,18 @@ size_t cas::KeyEncoder<cas::vstring_t>::ValueSize(const cas::vstring_t& value) {
 template<class VType>
 cas::BinarySK cas::KeyEncoder<VType>::Encode(cas::SearchKey<VType>& key) {
   cas::BinarySK bkey;
-  bkey.low_  = std::vector<uint8_t>(ValueSize(key.low_));
-  bkey.high_ = std::vector<uint8_t>(ValueSize(key.high_));
-  EncodeValue(key.low_,  bkey.low_);
-  EncodeValue(key.high_, bkey.high_);
-  EncodeQueryPath(key, bkey);
+  Encode(key, bkey);
   return bkey;
 }
 
+
+template<class VType>
+void cas::KeyEncoder<VType>::Encode(cas::SearchKey<VType>& key,
+    cas::BinarySK& bkey) {
+  EncodeBounds(key.low_, key.high_, bkey);
+  EncodeQueryPath(key, bkey);
+}
+
 template<class VType>
 cas::BinarySK cas::KeyEncoder<VType>::EncodeInsertKey(cas::SearchKey<VType>& key) {
   cas::BinarySK bkey;
@@ -142,15 +146,33 @@ cas::BinarySK cas::KeyEncoder<VType>::Encode(
     cas::SearchKey<VType>& key,
     cas::Surrogate& surrogate) {
   cas::BinarySK bkey;
-  bkey.low_  = std::vector<uint8_t>(ValueSize(key.low_));
-  bkey.high_ = std::vector<uint8_t>(ValueSize(key.high_));
-  EncodeValue(key.low_,  bkey.low_);
-  EncodeValue(key.high_, bkey.high_);
-  EncodeQueryPath(key, bkey, surrogate);
+  std::vector<uint8_t> label_buffer;
+  Encode(key, bkey, surrogate, label_buffer);
   return bkey;
 }
 
 
+template<class VType>
+void cas::KeyEncoder<VType>::Encode(
+    cas::SearchKey<VType>& key,
+    cas::BinarySK& bkey,
+    cas::Surrogate& surrogate,
+    std::vector<uint8_t>& label_buffer) {
+  EncodeBounds(key.low_, key.high_, bkey);
+  EncodeQueryPath(key, bkey, surrogate, label_buffer);
+}
+
+
+template<class VType>
+void cas::KeyEncoder<VType>::EncodeBounds(const VType& low, const VType& high,
+    cas::BinarySK& bkey) {
+  bkey.low_.resize(ValueSize(low));
+  bkey.high_.resize(ValueSize(high));
+  EncodeValue(low,  bkey.low_);
+  EncodeValue(high, bkey.high_);
+}
+
+
 template<>
 void
 cas::KeyEncoder<cas::vint32_t>::EncodeValue(
@@ -192,10 +214,8 @@ void cas::KeyEncoder<VType>::EncodeQueryPath(
     cas::BinarySK& bkey) {
   auto& path = key.path_[0];
 
-  bkey.path_.bytes_ = std::vector<uint8_t>(path.size());
-
-  bkey.path_.types_ = std::vector<cas::ByteType>(path.size(),
-      cas::ByteType::kTypeLabel);
+  bkey.path_.bytes_.assign(path.size(), 0x00);
+  bkey.path_.types_.assign(path.size(), cas::ByteType::kTypeLabel);
   for (size_t i = 0; i < path.size(); ++i) {
     if (path[i] == '?') {
       bkey.path_.bytes_[i] = cas::kByteChild;
@@ -239,20 +259,25 @@ template<class VType>
 void cas::KeyEncoder<VType>::EncodeQueryPath(
     cas::SearchKey<VType>& key,
     cas::BinarySK& bkey,
-    cas::Surrogate& surrogate) {
+    cas::Surrogate& surrogate,
+    std::vector<uint8_t>& label_buffer) {
   auto& path = key.path_[0];
+  bkey.path_.bytes_.clear();
+  bkey.path_.types_.clear();
 
-  std::string label_buffer = "";
+  size_t label_start = 0;
+  size_t label_size = 0;
   auto flush = [&]() -> void {
-    if (label_buffer.empty()) {
+    if (label_size == 0) {
       return;
     }
-    std::vector<uint8_t> label = surrogate.MapLabel(label_buffer);
-    for (size_t i = 0; i < label.size(); ++i) {
-      bkey.path_.bytes_.push_back(label[i]);
+    label_buffer.clear();
+    surrogate.MapLabel(path, label_start, label_size, label_buffer);
+    for (size_t i = 0; i < label_buffer.size(); ++i) {
+      bkey.path_.bytes_.push_back(label_buffer[i]);
       bkey.path_.types_.push_back(cas::ByteType::kTypeLabel);
     }
-    label_buffer = "";
+    label_size = 0;
   };
 
   for (size_t i = 0; i < path.size(); ++i) {
@@ -268,7 +293,10 @@ void cas::KeyEncoder<VType>::EncodeQueryPath(
       // do not translate '/'
       flush();
     } else {
-      label_buffer += path[i];
+      if (label_size == 0) {
+        label_start = i;
+      }
+      ++label_size;
     }
   }
   flush();
@@ -0,0 +1,74 @@
+#include "cas/match_buffer.hpp"
+#include "cas/key_encoding.hpp"
+#include <algorithm>
+
+
+void cas::MatchBuffer::Append(const std::vector<uint8_t>& buf_pat,
+    uint16_t len_pat,
+    const std::vector<uint8_t>& buf_val,
+    uint16_t len_val,
+    const cas::Node0& leaf) {
+  Match match;
+  match.offset_ = bytes_.size();
+  match.len_pat_ = len_pat;
+  match.len_val_ = len_val;
+  bytes_.insert(bytes_.end(), buf_pat.begin(), buf_pat.begin() + len_pat);
+  bytes_.insert(bytes_.end(), buf_val.begin(), buf_val.begin() + len_val);
+  for (cas::did_t did : leaf.dids_) {
+    match.did_ = did;
+    matches_.push_back(match);
+  }
+}
+
+
+size_t cas::MatchBuffer::Emit(cas::BinaryKeyEmitter& emitter) const {
+  cas::DidSpanEmitter span_emitter = [&](
+      const std::vector<uint8_t>& buffer_path,
+      const std::vector<uint8_t>& buffer_value,
+      const cas::DidSpan& dids) -> void {
+    for (cas::did_t did : dids) {
+      emitter(buffer_path, buffer_value, did);
+    }
+  };
+  return Emit(span_emitter);
+}
+
+
+size_t cas::MatchBuffer::Emit(cas::DidSpanEmitter& emitter) const {
+  std::vector<uint8_t> buf_pat(cas::kMaxPathLength+1, 0x00);
+  std::vector<uint8_t> buf_val(cas::kMaxValueLength+1, 0x00);
+  size_t len_pat = 0;
+  size_t len_val = 0;
+  std::vector<cas::did_t> dids;
+  size_t i = 0;
+  while (i < matches_.size()) {
+    // the matches of a leaf are adjacent and share their bytes
+    const Match& match = matches_[i];
+    dids.clear();
+    for (; i < matches_.size() && matches_[i].offset_ == match.offset_; ++i) {
+      dids.push_back(matches_[i].did_);
+    }
+    // the emitters decode the buffers up to the first null byte, so
+    // the bytes of the previous match must not survive
+    auto path = bytes_.begin() + match.offset_;
+    auto value = path + match.len_pat_;
+    std::copy(path, value, buf_pat.begin());
+    std::copy(value, value + match.len_val_, buf_val.begin());
+    for (size_t k = match.len_pat_; k < len_pat; ++k) {
+      buf_pat[k] = 0x00;
+    }
+    for (size_t k = match.len_val_; k < len_val; ++k) {
+      buf_val[k] = 0x00;
+    }
+    len_pat = match.len_pat_;
+    len_val = match.len_val_;
+    emitter(buf_pat, buf_val, cas::DidSpan(dids.data(), dids.size()));
+  }
+  return matches_.size();
+}
+
+
+void cas::MatchBuffer::Clear() {
+  bytes_.clear();
+  matches_.clear();
+}
@@ -0,0 +1,120 @@
+#include "cas/match_view.hpp"
+#include "cas/key_encoding.hpp"
+
+
+template<>
+cas::vint32_t cas::MatchView<cas::vint32_t>::Value() const {
+  cas::vint32_t value;
+  std::memcpy(&value, &buffer_value_[0], sizeof(value));
+  return __builtin_bswap32(value) ^ cas::kMsbMask32;
+}
+
+
+template<>
+cas::vint64_t cas::MatchView<cas::vint64_t>::Value() const {
+  cas::vint64_t value;
+  std::memcpy(&value, &buffer_value_[0], sizeof(value));
+  return __builtin_bswap64(value) ^ cas::kMsbMask64;
+}
+
+
+template<>
+cas::StringView cas::MatchView<cas::vstring_t>::StringValue() const {
+  const char* value = reinterpret_cast<const char*>(&buffer_value_[0]);
+  return cas::StringView(value, std::strlen(value));
+}
+
+
+template<>
+cas::vstring_t cas::MatchView<cas::vstring_t>::Value() const {
+  return StringValue().ToString();
+}
+
+
+template<class VType>
+bool cas::MatchView<VType>::NextLabel(size_t& pos,
+    cas::StringView& label) const {
+  if (surrogate_ != nullptr) {
+    // labels of bytes_per_label_ bytes; the padding of short paths
+    // maps to no label
+    size_t width = surrogate_->bytes_per_label_;
+    while (pos < surrogate_->NrBytes()) {
+      const std::string* text = surrogate_->FindLabel(&buffer_path_[pos]);
+      pos += width;
+      if (text != nullptr) {
+        label = cas::StringView(*text);
+        return true;
+      }
+    }
+    return false;
+  }
+  if (buffer_path_[pos] == cas::kNullByte) {
+    return false;
+  }
+  // skip the kPathSep in front of the label
+  size_t begin = ++pos;
+  while (buffer_path_[pos] != cas::kNullByte &&
+      buffer_path_[pos] != cas::kPathSep) {
+    ++pos;
+  }
+  label = cas::StringView(
+      reinterpret_cast<const char*>(&buffer_path_[begin]), pos - begin);
+  return true;
+}
+
+
+template<class VType>
+cas::StringView cas::MatchView<VType>::LastLabel() const {
+  size_t pos = 0;
+  cas::StringView label;
+  cas::StringView last;
+  while (NextLabel(pos, label)) {
+    last = label;
+  }
+  return last;
+}
+
+
+template<class VType>
+cas::StringView cas::MatchView<VType>::Label(size_t i) const {
+  size_t pos = 0;
+  cas::StringView label;
+  for (size_t k = 0; NextLabel(pos, label); ++k) {
+    if (k == i) {
+      return label;
+    }
+  }
+  return cas::StringView();
+}
+
+
+template<class VType>
+size_t cas::MatchView<VType>::NrLabels() const {
+  size_t pos = 0;
+  size_t nr_labels = 0;
+  cas::StringView label;
+  while (NextLabel(pos, label)) {
+    ++nr_labels;
+  }
+  return nr_labels;
+}
+
+
+template<class VType>
+cas::Key<VType> cas::MatchView<VType>::ToKey() const {
+  cas::Key<VType> key;
+  size_t pos = 0;
+  cas::StringView label;
+  while (NextLabel(pos, label)) {
+    key.path_.push_back(label.ToString());
+  }
+  key.value_ = Value();
+  key.did_ = did_;
+  return key;
+}
+
+
+// explicit instantiations to separate header from implementation
+template class cas::MatchView<cas::vint32_t>;
+template class cas::MatchView<cas::vint64_t>;
+template class cas::MatchView<cas::vstring_t>;
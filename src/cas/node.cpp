@@ -2,13 +2,19 @@
 #include "cas/utils.hpp"
 #include "cas/key_encoding.hpp"
 #include "cas/node0.hpp"
+#include "cas/node8.hpp"
+#include "cas/node16.hpp"
+#include "cas/node32.hpp"
+#include "cas/node48.hpp"
+#include "cas/node_allocator.hpp"
 
 #include <iostream>
 #include <cctype>
 #include <cassert>
 
 
-cas::Node::Node(cas::NodeType type) : type_(type) {
+cas::Node::Node(cas::NodeType type, uint16_t width)
+    : type_(type), width_(width) {
 }
 
 
@@ -27,12 +33,12 @@ bool cas::Node::IsValueNode() {
 }
 
 
-void cas::Node::ForEachChild(uint8_t low, cas::ChildIt callback) {
+bool cas::Node::ForEachChild(uint8_t low, cas::ChildIt callback) {
   return ForEachChild(low, 0xFF, callback);
 }
 
 
-void cas::Node::ForEachChild(cas::ChildIt callback) {
+bool cas::Node::ForEachChild(cas::ChildIt callback) {
   return ForEachChild(0x00, 0xFF, callback);
 }
 
@@ -49,6 +55,7 @@ size_t cas::Node::ValuePrefixSize() {
 
 void cas::Node::CollectStats(cas::IndexStats& stats, size_t depth) {
   stats.size_bytes_ += SizeBytes();
+  stats.size_bytes_classic_ += SizeBytes();
   ++stats.nr_nodes_;
   if (IsPathNode()) {
     ++stats.nr_path_nodes_;
@@ -59,6 +66,9 @@ void cas::Node::CollectStats(cas::IndexStats& stats, size_t depth) {
   if (depth > stats.max_depth_) {
     stats.max_depth_ = depth;
   }
+  stats.child_ref_bytes_ += NodeWidth() * sizeof(cas::ChildRef);
+  stats.child_ref_saved_bytes_ +=
+    NodeWidth() * (sizeof(cas::Node*) - sizeof(cas::ChildRef));
   switch (NodeWidth()) {
   case 0:
     ++stats.nr_node0_;
@@ -71,6 +81,17 @@ void cas::Node::CollectStats(cas::IndexStats& stats, size_t depth) {
       ++stats.nr_v_node4_;
     }
     break;
+  case 8:
+    if (IsPathNode()) {
+      ++stats.nr_p_node8_;
+    } else {
+      assert(IsValueNode());
+      ++stats.nr_v_node8_;
+    }
+    stats.size_bytes_classic_ +=
+      cas::NodeAllocator::InnerBlockBytes(sizeof(cas::Node16)) -
+      cas::NodeAllocator::InnerBlockBytes(sizeof(cas::Node8));
+    break;
   case 16:
     if (IsPathNode()) {
       ++stats.nr_p_node16_;
@@ -79,6 +100,17 @@ void cas::Node::CollectStats(cas::IndexStats& stats, size_t depth) {
       ++stats.nr_v_node16_;
     }
     break;
+  case 32:
+    if (IsPathNode()) {
+      ++stats.nr_p_node32_;
+    } else {
+      assert(IsValueNode());
+      ++stats.nr_v_node32_;
+    }
+    stats.size_bytes_classic_ +=
+      cas::NodeAllocator::InnerBlockBytes(sizeof(cas::Node48)) -
+      cas::NodeAllocator::InnerBlockBytes(sizeof(cas::Node32));
+    break;
   case 48:
     if (IsPathNode()) {
       ++stats.nr_p_node48_;
@@ -140,7 +172,7 @@ void cas::Node::Dump() {
   std::cout << "prefix_length_: " << prefix_.size() << std::endl;
   std::cout << "separator_pos_: " << separator_pos_ << std::endl;
   std::cout << "prefix_: ";
-  cas::Utils::DumpHexValues(prefix_);
+  cas::Utils::DumpHexValues(prefix_.ToVector());
   std::cout << std::endl;
 }
 
@@ -175,10 +207,10 @@ void cas::Node::DumpConcise(uint8_t edge_label, int indent) {
   }
   std::cout << "path[";
   /* cas::Utils::DumpChars(prefix_, separator_pos_); */
-  cas::Utils::DumpHexValues(prefix_, separator_pos_);
+  cas::Utils::DumpHexValues(prefix_.ToVector(), separator_pos_);
   std::cout << "] ";
   std::cout << "value[";
-  cas::Utils::DumpHexValues(prefix_, separator_pos_, prefix_.size());
+  cas::Utils::DumpHexValues(prefix_.ToVector(), separator_pos_, prefix_.size());
   std::cout << "] ";
   // print capacity of prefixes
   std::cout << "cap(" << prefix_.capacity();
@@ -234,12 +266,12 @@ void cas::Node::DumpConciseToFile(uint8_t edge_label, int indent, std::string fi
   output_file << "path[";
   /* cas::Utils::DumpChars(prefix_, separator_pos_); */
   output_file.close();
-  cas::Utils::DumpHexValuesToFile(prefix_, 0, separator_pos_, file_name);
+  cas::Utils::DumpHexValuesToFile(prefix_.ToVector(), 0, separator_pos_, file_name);
   output_file = std::ofstream (file_name, std::ios::app);
   output_file << "] ";
   output_file << "value[";
   output_file.close();
-  cas::Utils::DumpHexValuesToFile(prefix_, separator_pos_, prefix_.size(), file_name);
+  cas::Utils::DumpHexValuesToFile(prefix_.ToVector(), separator_pos_, prefix_.size(), file_name);
   output_file = std::ofstream (file_name, std::ios::app);
   output_file << "] ";
   // print capacity of prefixes
@@ -276,18 +308,19 @@ void cas::Node::DumpLatex(Node* parent, uint8_t edge_label, int indent,
   std::string istring = std::string(2*indent, ' ');
   std::cout << istring << "[";
   std::cout << "{(";
+  std::vector<uint8_t> prefix = prefix_.ToVector();
   std::cout << "\\pstr{";
   if (separator_pos_ == 0) {
     std::cout << "$\\epsilon$";
   } else {
-    cas::Utils::DumpChars(prefix_, 0, separator_pos_);
+    cas::Utils::DumpChars(prefix, 0, separator_pos_);
   }
   std::cout << "},\\vstr{";
   if (separator_pos_ == prefix_.size()) {
     std::cout << "$\\epsilon$";
   } else {
     if (string_value) {
-      cas::Utils::DumpChars(prefix_, separator_pos_, prefix_.size());
+      cas::Utils::DumpChars(prefix, separator_pos_, prefix.size());
     } else {
       for (size_t i = separator_pos_; i < prefix_.size(); ++i) {
         printf("%02X", prefix_[i]);
@@ -301,9 +334,10 @@ void cas::Node::DumpLatex(Node* parent, uint8_t edge_label, int indent,
   if (IsLeaf()) {
     std::cout << "\\\\$\\{";
     Node0* self = static_cast<Node0*>(this);
-    for (size_t pos = 0; pos < self->dids_.size(); ++pos) {
-      std::cout << "n_{" << self->dids_[pos] << "}";
-      if (pos < self->dids_.size()-1) {
+    size_t pos = 0;
+    for (cas::did_t did : self->dids_) {
+      std::cout << "n_{" << did << "}";
+      if (pos++ < self->dids_.size()-1) {
         std::cout << ",";
       }
     }
@@ -377,9 +411,9 @@ void cas::Node::DumpBuffer(uint8_t *buffer, size_t length) {
 }
 
 
-void cas::Node::DumpAddresses(cas::Node **buffer, size_t length) {
+void cas::Node::DumpAddresses(cas::ChildRef* buffer, size_t length) {
   for (size_t i = 0; i < length; ++i) {
-    printf("%p", buffer[i]);
+    printf("%p", static_cast<void*>(static_cast<cas::Node*>(buffer[i])));
     if (i < length-1) {
       printf(" ");
     }
@@ -1,14 +1,15 @@
 #include "cas/node0.hpp"
+#include "cas/node_allocator.hpp"
 #include <algorithm>
 #include <cassert>
 #include <iostream>
 
 
-cas::Node0::Node0() : cas::Node(cas::NodeType::Leaf) {}
+cas::Node0::Node0() : cas::Node(cas::NodeType::Leaf, 0) {}
 
 
 cas::Node0::Node0(const cas::BinaryKey& bkey, size_t path_pos, size_t value_pos)
-    : cas::Node(cas::NodeType::Leaf) {
+    : cas::Node(cas::NodeType::Leaf, 0) {
   size_t size = (bkey.path_.size() - path_pos) +
                 (bkey.value_.size() - value_pos);
   prefix_.reserve(size);
@@ -25,7 +26,7 @@ cas::Node0::Node0(const cas::BinaryKey& bkey, size_t path_pos, size_t value_pos)
 
 
 cas::Node0::Node0(const InterleavedKey& ikey, size_t pos)
-    : cas::Node(cas::NodeType::Leaf) {
+    : cas::Node(cas::NodeType::Leaf, 0) {
   assert(ikey.bytes_.size() >= pos);
   prefix_.reserve(ikey.bytes_.size() - pos);
 
@@ -65,7 +66,7 @@ cas::Node* cas::Node0::LocateChild(uint8_t /*key_byte*/) {
 
 
 bool cas::Node0::ContainsDid(cas::did_t did) {
-  return std::find(dids_.begin(), dids_.end(), did) != dids_.end();
+  return dids_.Contains(did);
 }
 
 
@@ -74,16 +75,17 @@ void cas::Node0::ReplaceBytePointer(uint8_t /*byte*/, cas::Node* /*child*/) {
 }
 
 
-void cas::Node0::ForEachChild(uint8_t /*low*/, uint8_t /*high*/,
+bool cas::Node0::ForEachChild(uint8_t /*low*/, uint8_t /*high*/,
                                 cas::ChildIt /*callback*/) {
   // has no children
+  return true;
 }
 
 
 size_t cas::Node0::SizeBytes() {
-  return sizeof(cas::Node0) +
-    (prefix_.capacity() * sizeof(uint8_t)) +
-    (dids_.capacity() * sizeof(cas::did_t));
+  return cas::NodeAllocator::LeafBlockBytes(sizeof(cas::Node0)) +
+    prefix_.HeapBytes() +
+    dids_.HeapBytes();
 }
 
 
@@ -97,8 +99,3 @@ void cas::Node0::Dump() {
   std::cout << std::endl;
   std::cout << std::endl;
 }
-
-
-int cas::Node0::NodeWidth() {
-  return 0;
-}
@@ -1,21 +1,23 @@
 #include "cas/node256.hpp"
 #include "cas/node48.hpp"
+#include "cas/node_allocator.hpp"
 #include <cassert>
 #include <iostream>
 
 
 cas::Node256::Node256(cas::NodeType type)
-    : cas::Node(type) {
-  memset(children_, 0, 256*sizeof(uintptr_t));
+    : cas::Node(type, 256) {
+  memset(children_, 0, 256*sizeof(ChildRef));
 }
 
 
 void cas::Node256::Put(uint8_t key_byte, Node* child) {
-  if (children_[key_byte] != nullptr) {
+  if (present_.Test(key_byte)) {
     assert(false);
     return;
   }
   children_[key_byte] = child;
+  present_.Set(key_byte);
   ++nr_children_;
 }
 
@@ -34,47 +36,35 @@ void cas::Node256::DeleteNode(uint8_t key_byte) {
   }
 
   children_[key_byte] = nullptr;
+  present_.Clear(key_byte);
   --nr_children_;
 }
 
 
-cas::Node* cas::Node256::LocateChild(uint8_t key_byte) {
-  return children_[key_byte];
-}
-
-
 std::vector<uint8_t> cas::Node256::GetKeys(){
-    std::vector<u_int8_t> node_keys;
-    for(int i = 0; i < 256; ++i){
-        if(children_[i] != nullptr){
-            node_keys.push_back(i);
-        }
-    }
-    return node_keys;
+    return present_.ToVector();
 }
 
 
-cas::Node* cas::Node256::Grow() {
+cas::Node* cas::Node256::Grow(cas::NodeAllocator& /*allocator*/) {
   assert(false);
   return nullptr;
 }
 
 
-cas::Node* cas::Node256::Shrink() {
-  assert(nr_children_ == 48);
-  cas::Node48* node48 = new cas::Node48(type_);
+cas::Node* cas::Node256::Shrink(cas::NodeAllocator& allocator) {
+  assert(nr_children_ == 48 && present_.Count() == 48);
+  cas::Node48* node48 = allocator.New<cas::Node48>(type_);
   node48->nr_children_ = 48;
   node48->separator_pos_ = separator_pos_;
   node48->prefix_ = std::move(prefix_);
+  node48->present_ = present_;
   int pos = 0;
-  for (int i = 0; i < 256; ++i) {
-    node48->indexes_[i] = cas::kEmptyIndex;
-    if (children_[i] != nullptr){
-      node48->indexes_[i] = static_cast<uint8_t>(pos);
-      node48->children_[pos] = children_[i];
-      ++pos;
-    }
-  }
+  present_.ForEachAscending([&](uint8_t byte) {
+    node48->indexes_[byte] = static_cast<uint8_t>(pos);
+    node48->children_[pos] = children_[byte];
+    ++pos;
+  });
   return node48;
 }
 
@@ -97,18 +87,15 @@ void cas::Node256::ReplaceBytePointer(uint8_t key_byte, cas::Node* child) {
 }
 
 
-void cas::Node256::ForEachChild(uint8_t low, uint8_t high,
+bool cas::Node256::ForEachChild(uint8_t low, uint8_t high,
                                   cas::ChildIt callback) {
-  for (int i = high; i >= low; --i) {
-    if (children_[i] != nullptr) {
-      callback(static_cast<uint8_t>(i), *children_[i]);
-    }
-  }
+  return VisitChildren(low, high, callback);
 }
 
 
 size_t cas::Node256::SizeBytes() {
-  return sizeof(cas::Node256) + (prefix_.capacity() * sizeof(uint8_t));
+  return cas::NodeAllocator::InnerBlockBytes(sizeof(cas::Node256)) +
+    prefix_.HeapBytes();
 }
 
 
@@ -120,8 +107,3 @@ void cas::Node256::Dump() {
   std::cout << std::endl;
   std::cout << std::endl;
 }
-
-
-int cas::Node256::NodeWidth() {
-  return 256;
-}
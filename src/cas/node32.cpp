@@ -0,0 +1,37 @@
+#include "cas/node32.hpp"
+#include "cas/node48.hpp"
+#include "cas/node16.hpp"
+#include "cas/node_allocator.hpp"
+#include <cassert>
+
+
+cas::Node32::Node32(cas::NodeType type)
+    : cas::SortedNode<32>(type) {
+}
+
+
+cas::Node* cas::Node32::Grow(cas::NodeAllocator& allocator) {
+  cas::Node48* node48 = allocator.New<cas::Node48>(type_);
+  node48->nr_children_ = 32;
+  node48->separator_pos_ = separator_pos_;
+  node48->prefix_ = std::move(prefix_);
+  for (int i = 0; i < nr_children_; ++i) {
+    node48->indexes_[keys_[i]] = i;
+    node48->present_.Set(keys_[i]);
+  }
+  std::memcpy(node48->children_, children_, 32*sizeof(ChildRef));
+  return node48;
+}
+
+
+cas::Node* cas::Node32::Shrink(cas::NodeAllocator& allocator) {
+  assert(nr_children_ == 16);
+  cas::Node16* node16 = allocator.New<cas::Node16>(type_);
+  MoveTo(node16, 16);
+  return node16;
+}
+
+
+bool cas::Node32::IsUnderfilled() {
+  return nr_children_ <= 16;
+}
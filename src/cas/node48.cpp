@@ -1,14 +1,15 @@
 #include "cas/node48.hpp"
-#include "cas/node16.hpp"
+#include "cas/node32.hpp"
 #include "cas/node256.hpp"
+#include "cas/node_allocator.hpp"
 #include <cassert>
 #include <iostream>
 
 
 cas::Node48::Node48(cas::NodeType type)
-    : cas::Node(type) {
+    : cas::Node(type, 48) {
   memset(indexes_, kEmptyIndex, 256*sizeof(uint8_t));
-  memset(children_, 0, 48*sizeof(uintptr_t));
+  memset(children_, 0, 48*sizeof(ChildRef));
 }
 
 
@@ -17,12 +18,11 @@ void cas::Node48::Put(uint8_t key_byte, Node* child) {
     // TODO
     exit(-1);
   }
-  int pos = 0;
-  while (pos < 48 && children_[pos] != nullptr) {
-    ++pos;
-  }
+  // DeleteNode keeps the children compacted
+  int pos = nr_children_;
   indexes_[key_byte] = pos;
   children_[pos] = child;
+  present_.Set(key_byte);
   ++nr_children_;
 }
 
@@ -41,71 +41,51 @@ void cas::Node48::DeleteNode(uint8_t key_byte) {
   }
   uint8_t pos = indexes_[key_byte];
   indexes_[key_byte] = kEmptyIndex;
+  present_.Clear(key_byte);
   --nr_children_;
-  std::memmove(children_+pos, children_+pos+1, (48-pos)*sizeof(uintptr_t));
+  std::memmove(children_+pos, children_+pos+1, (nr_children_-pos)*sizeof(ChildRef));
+  children_[nr_children_] = nullptr;
 
   //all indexes that are greater that pos should be reduced by 1 since on position pos we removed child
-  for (int i = 0; i < 256; i++) {
-    if (indexes_[i] != kEmptyIndex && indexes_[i] > pos) {
-      indexes_[i] = indexes_[i] - 1;
+  present_.ForEachAscending([&](uint8_t byte) {
+    if (indexes_[byte] > pos) {
+      indexes_[byte] = indexes_[byte] - 1;
     }
-  }
-
-  //set rest to 0, but it is already regulated with the nur_children when we do a insert
-//  memset(children_+nr_children_, 0, (48-nr_children_)*sizeof(uintptr_t));
-}
-
-
-cas::Node* cas::Node48::LocateChild(uint8_t key_byte) {
-  uint8_t index = indexes_[key_byte];
-  if (index == cas::kEmptyIndex) {
-    return nullptr;
-  } else {
-    return children_[index];
-  }
+  });
 }
 
 
 std::vector<uint8_t> cas::Node48::GetKeys(){
-    std::vector<u_int8_t> node_keys;
-    for(int i = 0; i < 256; ++i){
-        if(indexes_[i] != cas::kEmptyIndex){
-            node_keys.push_back(static_cast<uint8_t>(i));
-        }
-    }
-    return node_keys;
+    return present_.ToVector();
 }
 
 
-cas::Node* cas::Node48::Grow() {
-  cas::Node256* node256 = new cas::Node256(type_);
+cas::Node* cas::Node48::Grow(cas::NodeAllocator& allocator) {
+  cas::Node256* node256 = allocator.New<cas::Node256>(type_);
   node256->nr_children_ = 48;
   node256->separator_pos_ = separator_pos_;
   node256->prefix_ = std::move(prefix_);
-  for (int i = 0; i < 256; ++i) {
-    if (indexes_[i] != cas::kEmptyIndex) {
-      node256->children_[i] = children_[indexes_[i]];
-    }
-  }
+  node256->present_ = present_;
+  present_.ForEachAscending([&](uint8_t byte) {
+    node256->children_[byte] = children_[indexes_[byte]];
+  });
   return node256;
 }
 
 
-cas::Node* cas::Node48::Shrink() {
-  assert(nr_children_ == 16);
-  cas::Node16* node16 = new cas::Node16(type_);
-  node16->nr_children_ = 16;
-  node16->separator_pos_ = separator_pos_;
-  node16->prefix_ = std::move(prefix_);
+cas::Node* cas::Node48::Shrink(cas::NodeAllocator& allocator) {
+  assert(nr_children_ == 32 && present_.Count() == 32);
+  cas::Node32* node32 = allocator.New<cas::Node32>(type_);
+  node32->nr_children_ = 32;
+  node32->separator_pos_ = separator_pos_;
+  node32->prefix_ = std::move(prefix_);
   int pos = 0;
-  for (int i = 0; i < 256; ++i) {
-    if (indexes_[i] != cas::kEmptyIndex) {
-      node16->keys_[pos] = static_cast<uint8_t>(i);
-      node16->children_[pos] = children_[indexes_[i]];
-      ++pos;
-    }
-  }
-  return node16;
+  present_.ForEachAscending([&](uint8_t byte) {
+    node32->keys_[pos] = byte;
+    node32->children_[pos] = children_[indexes_[byte]];
+    ++pos;
+  });
+  return node32;
 }
 
 
@@ -115,7 +95,7 @@ bool cas::Node48::IsFull() {
 
 
 bool cas::Node48::IsUnderfilled() {
-  return nr_children_ <= 16;
+  return nr_children_ <= 32;
 }
 
 
@@ -128,18 +108,15 @@ void cas::Node48::ReplaceBytePointer(uint8_t key_byte, cas::Node* child) {
 }
 
 
-void cas::Node48::ForEachChild(uint8_t low, uint8_t high,
+bool cas::Node48::ForEachChild(uint8_t low, uint8_t high,
                                  cas::ChildIt callback) {
-  for (int i = high; i >= low; --i) {
-    if (indexes_[i] != cas::kEmptyIndex) {
-      callback(static_cast<uint8_t>(i), *children_[indexes_[i]]);
-    }
-  }
+  return VisitChildren(low, high, callback);
 }
 
 
 size_t cas::Node48::SizeBytes() {
-  return sizeof(cas::Node48) + (prefix_.capacity() * sizeof(uint8_t));
+  return cas::NodeAllocator::InnerBlockBytes(sizeof(cas::Node48)) +
+    prefix_.HeapBytes();
 }
 
 
@@ -157,17 +134,10 @@ void cas::Node48::Dump() {
 
 
 void cas::Node48::DumpIndexes() {
-  for (int i = 0; i < 256; ++i) {
-    if (indexes_[i] != cas::kEmptyIndex) {
-      printf("0x%02X(%d)", i, indexes_[i]);
-      if (i < 256-1) {
-        std::cout << " ";
-      }
+  present_.ForEachAscending([&](uint8_t byte) {
+    printf("0x%02X(%d)", byte, indexes_[byte]);
+    if (byte < 256-1) {
+      std::cout << " ";
     }
-  }
-}
-
-
-int cas::Node48::NodeWidth() {
-  return 48;
+  });
 }
@@ -0,0 +1,30 @@
+#include "cas/node8.hpp"
+#include "cas/node16.hpp"
+#include "cas/node4.hpp"
+#include "cas/node_allocator.hpp"
+#include <cassert>
+
+
+cas::Node8::Node8(cas::NodeType type)
+    : cas::SortedNode<8>(type) {
+}
+
+
+cas::Node* cas::Node8::Grow(cas::NodeAllocator& allocator) {
+  cas::Node16* node16 = allocator.New<cas::Node16>(type_);
+  MoveTo(node16, 8);
+  return node16;
+}
+
+
+cas::Node* cas::Node8::Shrink(cas::NodeAllocator& allocator) {
+  assert(nr_children_ == 4);
+  cas::Node4* node4 = allocator.New<cas::Node4>(type_);
+  MoveTo(node4, 4);
+  return node4;
+}
+
+
+bool cas::Node8::IsUnderfilled() {
+  return nr_children_ <= 4;
+}
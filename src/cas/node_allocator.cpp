@@ -0,0 +1,204 @@
+#include "cas/node_allocator.hpp"
+#include "cas/node0.hpp"
+#include "cas/node4.hpp"
+#include "cas/node8.hpp"
+#include "cas/node16.hpp"
+#include "cas/node32.hpp"
+#include "cas/node48.hpp"
+#include "cas/node256.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+
+#ifdef CAS_COMPACT_REFS
+cas::NodeAllocator::Directory cas::NodeAllocator::directory_;
+#endif
+
+
+namespace {
+
+#ifdef CAS_COMPACT_REFS
+static_assert(cas::NodeAllocator::kSlabBytes / cas::NodeAllocator::kBlockAlign
+    <= (size_t{1} << cas::NodeAllocator::kOffsetBits),
+    "block offsets do not fit into a node reference");
+#endif
+
+constexpr size_t RoundUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+
+uint8_t* cas::NodeAllocator::Slab::Block(size_t i) {
+  static const size_t header_bytes = RoundUp(sizeof(Slab), 64);
+  return reinterpret_cast<uint8_t*>(this) + header_bytes + i * block_size_;
+}
+
+
+cas::NodeAllocator::NodeAllocator() {
+  InitClass<cas::Node0>(LeafBlockBytes(sizeof(cas::Node0)));
+  InitClass<cas::Node4>(InnerBlockBytes(sizeof(cas::Node4)));
+  InitClass<cas::Node8>(InnerBlockBytes(sizeof(cas::Node8)));
+  InitClass<cas::Node16>(InnerBlockBytes(sizeof(cas::Node16)));
+  InitClass<cas::Node32>(InnerBlockBytes(sizeof(cas::Node32)));
+  InitClass<cas::Node48>(InnerBlockBytes(sizeof(cas::Node48)));
+  InitClass<cas::Node256>(InnerBlockBytes(sizeof(cas::Node256)));
+}
+
+
+cas::NodeAllocator::~NodeAllocator() {
+  Release();
+}
+
+
+void* cas::NodeAllocator::Allocate(int size_class) {
+  SizeClass& sc = classes_[size_class];
+  void* block;
+  if (sc.free_list_ != nullptr) {
+    block = sc.free_list_;
+    sc.free_list_ = sc.free_list_->next_;
+    --sc.nr_free_;
+  } else {
+    Slab* slab = sc.slabs_;
+    if (slab == nullptr || slab->nr_used_ == slab->nr_blocks_) {
+      slab = NewSlab(sc);
+      slab->size_class_ = size_class;
+    }
+    block = slab->Block(slab->nr_used_++);
+  }
+  Slab* slab = SlabOf(block);
+  size_t i = (static_cast<uint8_t*>(block) - slab->Block(0)) / slab->block_size_;
+  slab->live_[i / 64] |= (uint64_t{1} << (i % 64));
+  ++slab->nr_live_;
+  ++sc.nr_live_;
+  return block;
+}
+
+
+cas::NodeAllocator::Slab* cas::NodeAllocator::NewSlab(SizeClass& sc) {
+  void* memory = nullptr;
+  if (posix_memalign(&memory, kSlabBytes, kSlabBytes) != 0) {
+    throw std::bad_alloc{};
+  }
+  Slab* slab = static_cast<Slab*>(memory);
+  std::memset(slab, 0, sizeof(Slab));
+  slab->block_size_ = sc.block_size_;
+  slab->nr_blocks_ = (kSlabBytes - (slab->Block(0) - static_cast<uint8_t*>(memory)))
+    / sc.block_size_;
+#ifdef CAS_COMPACT_REFS
+  try {
+    Register(slab);
+  } catch (...) {
+    free(memory);
+    throw;
+  }
+#endif
+  slab->next_ = sc.slabs_;
+  sc.slabs_ = slab;
+  ++sc.nr_slabs_;
+  return slab;
+}
+
+
+cas::NodeAllocator::Slab* cas::NodeAllocator::SlabOf(void* block) {
+  uintptr_t address = reinterpret_cast<uintptr_t>(block);
+  return reinterpret_cast<Slab*>(address & ~(uintptr_t{kSlabBytes} - 1));
+}
+
+
+#ifdef CAS_COMPACT_REFS
+void cas::NodeAllocator::Register(Slab* slab) {
+  std::lock_guard<std::mutex> lock(directory_.mutex_);
+  uint32_t id;
+  if (!directory_.free_ids_.empty()) {
+    id = directory_.free_ids_.back();
+    directory_.free_ids_.pop_back();
+  } else if (directory_.next_id_ < kMaxSlabs) {
+    id = directory_.next_id_++;
+  } else {
+    // more slabs than 32-bit references can address
+    throw std::bad_alloc{};
+  }
+  Slab**& chunk = directory_.chunks_[id / kDirectoryChunk];
+  if (chunk == nullptr) {
+    chunk = new Slab*[kDirectoryChunk]();
+  }
+  chunk[id % kDirectoryChunk] = slab;
+  ++directory_.nr_registered_[id / kDirectoryChunk];
+  slab->id_ = id;
+}
+
+
+void cas::NodeAllocator::Unregister(Slab* slab) {
+  std::lock_guard<std::mutex> lock(directory_.mutex_);
+  Slab**& chunk = directory_.chunks_[slab->id_ / kDirectoryChunk];
+  chunk[slab->id_ % kDirectoryChunk] = nullptr;
+  if (--directory_.nr_registered_[slab->id_ / kDirectoryChunk] == 0) {
+    delete[] chunk;
+    chunk = nullptr;
+  }
+  directory_.free_ids_.push_back(slab->id_);
+}
+#endif
+
+
+void cas::NodeAllocator::Delete(cas::Node* node) {
+  if (node == nullptr) {
+    return;
+  }
+  Slab* slab = SlabOf(node);
+  SizeClass& sc = classes_[slab->size_class_];
+  size_t i = (reinterpret_cast<uint8_t*>(node) - slab->Block(0)) / slab->block_size_;
+  assert(slab->IsLive(i));
+  node->~Node();
+  slab->live_[i / 64] &= ~(uint64_t{1} << (i % 64));
+  --slab->nr_live_;
+  --sc.nr_live_;
+
+  FreeBlock* block = reinterpret_cast<FreeBlock*>(node);
+  block->next_ = sc.free_list_;
+  sc.free_list_ = block;
+  ++sc.nr_free_;
+}
+
+
+void cas::NodeAllocator::Release() {
+  for (auto& sc : classes_) {
+    Slab* slab = sc.slabs_;
+    while (slab != nullptr) {
+      // nodes still own heap memory (e.g., their prefix), so live
+      // blocks have to be destructed before the slab is returned
+      for (size_t i = 0; slab->nr_live_ > 0 && i < slab->nr_used_; ++i) {
+        if (slab->IsLive(i)) {
+          reinterpret_cast<cas::Node*>(slab->Block(i))->~Node();
+          --slab->nr_live_;
+        }
+      }
+      Slab* next = slab->next_;
+#ifdef CAS_COMPACT_REFS
+      Unregister(slab);
+#endif
+      free(slab);
+      slab = next;
+    }
+    sc.slabs_ = nullptr;
+    sc.free_list_ = nullptr;
+    sc.nr_slabs_ = 0;
+    sc.nr_live_ = 0;
+    sc.nr_free_ = 0;
+  }
+}
+
+
+void cas::NodeAllocator::CollectStats(cas::IndexStats& stats) const {
+  for (const auto& sc : classes_) {
+    stats.alloc_slabs_ += sc.nr_slabs_;
+    stats.alloc_reserved_bytes_ += sc.nr_slabs_ * kSlabBytes;
+    stats.alloc_live_nodes_ += sc.nr_live_;
+    stats.alloc_free_nodes_ += sc.nr_free_;
+    stats.alloc_live_bytes_ += sc.nr_live_ * sc.block_size_;
+    stats.alloc_padding_bytes_ += sc.nr_live_ * (sc.block_size_ - sc.node_size_);
+  }
+}
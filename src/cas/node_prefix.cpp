@@ -0,0 +1,104 @@
+#include "cas/node_prefix.hpp"
+#include <cassert>
+#include <limits>
+
+
+cas::NodePrefix::NodePrefix(const cas::NodePrefix& other) {
+  assign(other.begin(), other.end());
+}
+
+
+cas::NodePrefix::NodePrefix(cas::NodePrefix&& other)
+  : size_(other.size_)
+  , capacity_(other.capacity_) {
+  std::memcpy(bytes_, other.bytes_, kInlineBytes);
+  other.size_ = 0;
+  other.capacity_ = kInlineBytes;
+}
+
+
+cas::NodePrefix::~NodePrefix() {
+  if (!IsInline()) {
+    delete[] HeapBuffer();
+  }
+}
+
+
+cas::NodePrefix& cas::NodePrefix::operator=(const cas::NodePrefix& other) {
+  if (this != &other) {
+    assign(other.begin(), other.end());
+  }
+  return *this;
+}
+
+
+cas::NodePrefix& cas::NodePrefix::operator=(cas::NodePrefix&& other) {
+  if (this != &other) {
+    if (!IsInline()) {
+      delete[] HeapBuffer();
+    }
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    std::memcpy(bytes_, other.bytes_, kInlineBytes);
+    other.size_ = 0;
+    other.capacity_ = kInlineBytes;
+  }
+  return *this;
+}
+
+
+cas::NodePrefix& cas::NodePrefix::operator=(const std::vector<uint8_t>& bytes) {
+  assign(bytes.data(), bytes.data() + bytes.size());
+  return *this;
+}
+
+
+void cas::NodePrefix::assign(const uint8_t* first, const uint8_t* last) {
+  size_ = 0;
+  reserve(last - first);
+  std::copy(first, last, data());
+  size_ = last - first;
+}
+
+
+void cas::NodePrefix::reserve(size_t capacity) {
+  if (capacity > capacity_) {
+    Resize(capacity);
+  }
+}
+
+
+void cas::NodePrefix::shrink_to_fit() {
+  if (!IsInline() && size_ < capacity_) {
+    Resize(size_ <= kInlineBytes ? kInlineBytes : size_);
+  }
+}
+
+
+cas::NodePrefix::iterator cas::NodePrefix::erase(cas::NodePrefix::const_iterator pos) {
+  uint8_t* p = data() + (pos - data());
+  std::memmove(p, p + 1, end() - p - 1);
+  --size_;
+  return p;
+}
+
+
+void cas::NodePrefix::Resize(size_t capacity) {
+  assert(capacity >= size_);
+  assert(capacity <= std::numeric_limits<uint16_t>::max());
+  uint8_t* old_buffer = IsInline() ? nullptr : HeapBuffer();
+  if (capacity <= kInlineBytes) {
+    // move the bytes back into the node
+    if (old_buffer != nullptr) {
+      std::memcpy(bytes_, old_buffer, size_);
+      delete[] old_buffer;
+    }
+    capacity_ = kInlineBytes;
+    return;
+  }
+  uint8_t* buffer = new uint8_t[capacity];
+  std::memcpy(buffer, old_buffer != nullptr ? old_buffer : bytes_, size_);
+  delete[] old_buffer;
+  SetHeapBuffer(buffer);
+  capacity_ = static_cast<uint16_t>(capacity);
+}
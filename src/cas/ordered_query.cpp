@@ -0,0 +1,182 @@
+#include "cas/ordered_query.hpp"
+#include "cas/key_encoding.hpp"
+#include <algorithm>
+#include <cstring>
+
+
+template<class VType>
+cas::OrderedQuery<VType>::OrderedQuery(cas::BinarySK& key,
+        cas::PathMatcher& pm,
+        cas::ValueOrder order)
+    : key_(key)
+    , pm_(pm)
+    , order_(order)
+    , buf_pat_(cas::kMaxPathLength+1, 0x00)
+    , buf_val_(cas::kMaxValueLength+1, 0x00)
+{}
+
+
+template<class VType>
+void cas::OrderedQuery<VType>::AddIndex(cas::Node* root) {
+  if (root == nullptr) {
+    return;
+  }
+  std::unique_ptr<Stream> stream(new Stream());
+  stream->query_.reset(new cas::Query<VType>(root, key_, pm_,
+        cas::BinaryKeyEmitter(), stream->context_));
+  Entry entry;
+  entry.task_.root_ = root;
+  entry.task_.state_.node_ = root;
+  entry.task_.state_.parent_type_ = cas::NodeType::Path; // doesn't matter
+  entry.task_.state_.parent_byte_ = 0x00; // doesn't matter
+  entry.task_.state_.len_pat_ = 0;
+  entry.task_.state_.len_val_ = 0;
+  entry.task_.state_.vl_pos_ = 0;
+  entry.task_.state_.vh_pos_ = 0;
+  entry.task_.state_.depth_ = 0;
+  entry.leaf_ = nullptr;
+  Push(*stream, std::move(entry));
+  streams_.push_back(std::move(stream));
+}
+
+
+template<class VType>
+cas::Node0* cas::OrderedQuery<VType>::NextLeaf() {
+  // k-way merge of the streams, each of which has its next complete
+  // match at the top of its heap
+  Stream* next = nullptr;
+  for (auto& stream : streams_) {
+    if (Advance(*stream) && (next == nullptr ||
+          Precedes(stream->heap_.front(), next->heap_.front()))) {
+      next = stream.get();
+    }
+  }
+  if (next == nullptr) {
+    return nullptr;
+  }
+  Entry entry = Pop(*next);
+  CopyToBuffer(buf_pat_, len_pat_, entry.task_.path_);
+  CopyToBuffer(buf_val_, len_val_, entry.task_.value_);
+  return entry.leaf_;
+}
+
+
+template<class VType>
+void cas::OrderedQuery<VType>::Execute(cas::BinaryKeyEmitter emitter,
+    size_t limit) {
+  const auto& t_start = std::chrono::high_resolution_clock::now();
+  size_t nr_matches = 0;
+  cas::Node0* leaf;
+  while (nr_matches < limit && (leaf = NextLeaf()) != nullptr) {
+    for (cas::did_t did : leaf->dids_) {
+      if (nr_matches == limit) {
+        break;
+      }
+      emitter(buf_pat_, buf_val_, did);
+      ++nr_matches;
+    }
+  }
+  const auto& t_end = std::chrono::high_resolution_clock::now();
+  stats_.nr_matches_ = static_cast<int32_t>(nr_matches);
+  stats_.runtime_mus_ =
+    std::chrono::duration_cast<std::chrono::microseconds>(t_end-t_start).count();
+}
+
+
+template<class VType>
+const cas::QueryStats cas::OrderedQuery<VType>::Stats() const {
+  cas::QueryStats stats = stats_;
+  for (const auto& stream : streams_) {
+    stats.read_path_nodes_  += stream->query_->Stats().read_path_nodes_;
+    stats.read_value_nodes_ += stream->query_->Stats().read_value_nodes_;
+  }
+  return stats;
+}
+
+
+template<class VType>
+bool cas::OrderedQuery<VType>::Advance(Stream& stream) {
+  while (!stream.heap_.empty() && stream.heap_.front().leaf_ == nullptr) {
+    Entry entry = Pop(stream);
+    children_.clear();
+    cas::Node0* leaf = stream.query_->Expand(entry.task_, children_);
+    for (auto& child : children_) {
+      Entry pending;
+      pending.bound_ = std::vector<uint8_t>(child.value_);
+      if (child.state_.parent_type_ == cas::NodeType::Value) {
+        // the byte that leads to the child is a value byte as well
+        pending.bound_.push_back(child.state_.parent_byte_);
+      }
+      pending.task_ = std::move(child);
+      pending.leaf_ = nullptr;
+      Push(stream, std::move(pending));
+    }
+    if (leaf != nullptr) {
+      // the leaf's own prefix completes its value, which may now come
+      // after other pending subtrees
+      const auto& query = *stream.query_;
+      Entry match;
+      match.task_.root_ = entry.task_.root_;
+      match.task_.state_ = entry.task_.state_;
+      match.task_.path_ = std::vector<uint8_t>(query.BufferPath().begin(),
+          query.BufferPath().begin() + query.LeafPathLength());
+      match.task_.value_ = std::vector<uint8_t>(query.BufferValue().begin(),
+          query.BufferValue().begin() + query.LeafValueLength());
+      match.bound_ = std::vector<uint8_t>(match.task_.value_);
+      match.leaf_ = leaf;
+      Push(stream, std::move(match));
+    }
+  }
+  return !stream.heap_.empty();
+}
+
+
+template<class VType>
+void cas::OrderedQuery<VType>::Push(Stream& stream, Entry&& entry) {
+  stream.heap_.push_back(std::move(entry));
+  std::push_heap(stream.heap_.begin(), stream.heap_.end(),
+      [this](const Entry& a, const Entry& b) { return Precedes(b, a); });
+}
+
+
+template<class VType>
+typename cas::OrderedQuery<VType>::Entry
+cas::OrderedQuery<VType>::Pop(Stream& stream) {
+  std::pop_heap(stream.heap_.begin(), stream.heap_.end(),
+      [this](const Entry& a, const Entry& b) { return Precedes(b, a); });
+  Entry entry = std::move(stream.heap_.back());
+  stream.heap_.pop_back();
+  return entry;
+}
+
+
+template<class VType>
+bool cas::OrderedQuery<VType>::Precedes(const Entry& a, const Entry& b) const {
+  size_t len = std::min(a.bound_.size(), b.bound_.size());
+  int c = len == 0 ? 0 : std::memcmp(&a.bound_[0], &b.bound_[0], len);
+  if (c != 0) {
+    return order_ == cas::ValueOrder::Ascending ? c < 0 : c > 0;
+  }
+  // a bound that is a prefix of the other one bounds its subtree in
+  // either order, so it has to be expanded first
+  return a.bound_.size() < b.bound_.size();
+}
+
+
+template<class VType>
+void cas::OrderedQuery<VType>::CopyToBuffer(std::vector<uint8_t>& buffer,
+    size_t& len, const std::vector<uint8_t>& bytes) {
+  // the emitters decode the buffers up to the first null byte, so the
+  // bytes of the previous match must not survive
+  std::copy(bytes.begin(), bytes.end(), buffer.begin());
+  for (size_t i = bytes.size(); i < len; ++i) {
+    buffer[i] = 0x00;
+  }
+  len = bytes.size();
+}
+
+
+// explicit instantiations to separate header from implementation
+template class cas::OrderedQuery<cas::vint32_t>;
+template class cas::OrderedQuery<cas::vint64_t>;
+template class cas::OrderedQuery<cas::vstring_t>;
@@ -0,0 +1,215 @@
+#include "cas/parallel_query.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+
+template<class VType>
+cas::ParallelQuery<VType>::ParallelQuery(cas::Node* root,
+        cas::BinarySK& key,
+        cas::PathMatcher& pm,
+        cas::BinaryKeyEmitter emitter,
+        size_t nr_threads)
+    : root_(root)
+    , auxiliary_index_(nullptr)
+    , key_(key)
+    , pm_(pm)
+    , emitter_(std::move(emitter))
+    , nr_threads_(std::max<size_t>(nr_threads, 1))
+    , nr_pending_(0)
+    , nr_idle_(0)
+{
+  for (size_t i = 0; i < nr_threads_; ++i) {
+    std::unique_ptr<Worker> worker(new Worker());
+    worker->query_.reset(new cas::Query<VType>(root_, key_, pm_,
+          cas::BinaryKeyEmitter(), worker->context_));
+    workers_.push_back(std::move(worker));
+  }
+}
+
+
+template<class VType>
+void cas::ParallelQuery<VType>::Execute() {
+  const auto& t_start_main = std::chrono::high_resolution_clock::now();
+  Traverse(root_);
+  EmitMatches();
+  const auto& t_end_main = std::chrono::high_resolution_clock::now();
+  Traverse(auxiliary_index_);
+  EmitMatches();
+  const auto& t_end_aux = std::chrono::high_resolution_clock::now();
+
+  for (auto& worker : workers_) {
+    const cas::QueryStats& stats = worker->query_->Stats();
+    stats_.read_path_nodes_  += stats.read_path_nodes_;
+    stats_.read_value_nodes_ += stats.read_value_nodes_;
+  }
+  stats_.runtime_main_mus_ =
+    std::chrono::duration_cast<std::chrono::microseconds>(t_end_main-t_start_main).count();
+  stats_.runtime_aux_mus_ =
+    std::chrono::duration_cast<std::chrono::microseconds>(t_end_aux-t_end_main).count();
+  stats_.runtime_mus_ =
+    std::chrono::duration_cast<std::chrono::microseconds>(t_end_aux-t_start_main).count();
+}
+
+
+template<class VType>
+void cas::ParallelQuery<VType>::Traverse(cas::Node* root) {
+  if (root == nullptr) {
+    return;
+  }
+  cas::QueryTask initial_task;
+  initial_task.root_ = root;
+  initial_task.state_.node_ = root;
+  initial_task.state_.parent_type_ = cas::NodeType::Path; // doesn't matter
+  initial_task.state_.parent_byte_ = 0x00; // doesn't matter;
+  initial_task.state_.len_pat_ = 0;
+  initial_task.state_.len_val_ = 0;
+  initial_task.state_.vl_pos_ = 0;
+  initial_task.state_.vh_pos_ = 0;
+  initial_task.state_.depth_ = 0;
+
+  // expand the frontier breadth-first on the calling thread
+  Worker& first = *workers_[0];
+  std::deque<cas::QueryTask> frontier;
+  std::vector<cas::QueryTask> children;
+  frontier.push_back(std::move(initial_task));
+  while (!frontier.empty() &&
+      frontier.size() < nr_threads_ * kTasksPerThread) {
+    cas::QueryTask task = std::move(frontier.front());
+    frontier.pop_front();
+    children.clear();
+    cas::Node0* leaf = first.query_->Expand(task, children);
+    if (leaf != nullptr) {
+      Collect(first, leaf);
+    }
+    for (auto& child : children) {
+      frontier.push_back(std::move(child));
+    }
+  }
+  if (frontier.empty()) {
+    return;
+  }
+
+  for (size_t i = 0; i < frontier.size(); ++i) {
+    workers_[i % nr_threads_]->tasks_.push_back(std::move(frontier[i]));
+  }
+  nr_pending_ = frontier.size();
+  nr_idle_ = 0;
+
+  std::vector<std::thread> threads;
+  for (size_t id = 1; id < nr_threads_; ++id) {
+    threads.emplace_back(&cas::ParallelQuery<VType>::Work, this, id);
+  }
+  Work(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+
+template<class VType>
+void cas::ParallelQuery<VType>::Work(size_t id) {
+  Worker& worker = *workers_[id];
+  cas::QueryTask task;
+  bool idle = false;
+  for (;;) {
+    if (PopTask(worker, task) || StealTask(id, task)) {
+      if (idle) {
+        --nr_idle_;
+        idle = false;
+      }
+      Run(worker, task);
+      --nr_pending_;
+    } else if (nr_pending_ == 0) {
+      break;
+    } else {
+      if (!idle) {
+        ++nr_idle_;
+        idle = true;
+      }
+      std::this_thread::yield();
+    }
+  }
+  if (idle) {
+    --nr_idle_;
+  }
+}
+
+
+template<class VType>
+void cas::ParallelQuery<VType>::Run(Worker& worker, const cas::QueryTask& task) {
+  cas::Query<VType>& query = *worker.query_;
+  cas::QueryTask split;
+  query.Resume(task);
+  cas::Node0* leaf;
+  while ((leaf = query.NextLeaf()) != nullptr) {
+    Collect(worker, leaf);
+    if (nr_idle_ > 0) {
+      std::lock_guard<std::mutex> lock(worker.mutex_);
+      if (worker.tasks_.empty() && query.Split(split)) {
+        // counted before the current task finishes, so that
+        // nr_pending_ cannot drop to zero in between
+        ++nr_pending_;
+        worker.tasks_.push_back(std::move(split));
+      }
+    }
+  }
+}
+
+
+template<class VType>
+bool cas::ParallelQuery<VType>::PopTask(Worker& worker, cas::QueryTask& task) {
+  std::lock_guard<std::mutex> lock(worker.mutex_);
+  if (worker.tasks_.empty()) {
+    return false;
+  }
+  task = std::move(worker.tasks_.back());
+  worker.tasks_.pop_back();
+  return true;
+}
+
+
+template<class VType>
+bool cas::ParallelQuery<VType>::StealTask(size_t id, cas::QueryTask& task) {
+  for (size_t i = 1; i < nr_threads_; ++i) {
+    Worker& victim = *workers_[(id + i) % nr_threads_];
+    std::lock_guard<std::mutex> lock(victim.mutex_);
+    if (!victim.tasks_.empty()) {
+      // the oldest task of the victim is its largest one
+      task = std::move(victim.tasks_.front());
+      victim.tasks_.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+
+template<class VType>
+void cas::ParallelQuery<VType>::Collect(Worker& worker, cas::Node0* leaf) {
+  const cas::Query<VType>& query = *worker.query_;
+  worker.matches_.Append(query.BufferPath(), query.LeafPathLength(),
+      query.BufferValue(), query.LeafValueLength(), *leaf);
+}
+
+
+template<class VType>
+void cas::ParallelQuery<VType>::EmitMatches() {
+  for (auto& worker : workers_) {
+    stats_.nr_matches_ += worker->matches_.Emit(emitter_);
+    worker->matches_.Clear();
+  }
+}
+
+
+template<class VType>
+void cas::ParallelQuery<VType>::setAuxiliaryIndex(cas::Node* node) {
+  auxiliary_index_ = node;
+}
+
+
+// explicit instantiations to separate header from implementation
+template class cas::ParallelQuery<cas::vint32_t>;
+template class cas::ParallelQuery<cas::vint64_t>;
+template class cas::ParallelQuery<cas::vstring_t>;
@@ -0,0 +1,244 @@
+#include "cas/path_automaton.hpp"
+#include "cas/key_encoding.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+
+bool cas::PathAutomaton::Compilable(const cas::BinaryQP& query_path) {
+  return query_path.bytes_.size() <= kMaxQueryLength;
+}
+
+
+cas::PathAutomaton::PathAutomaton(const cas::BinaryQP& query_path)
+    : query_path_(query_path)
+    , bytes_per_label_(0)
+    , nr_bytes_(0)
+{
+  Compile();
+}
+
+
+cas::PathAutomaton::PathAutomaton(const cas::BinaryQP& query_path,
+        size_t bytes_per_label,
+        size_t nr_bytes)
+    : query_path_(query_path)
+    , bytes_per_label_(bytes_per_label)
+    , nr_bytes_(nr_bytes)
+{
+  assert(bytes_per_label_ > 0);
+  Compile();
+}
+
+
+void cas::PathAutomaton::Compile() {
+  assert(Compilable(query_path_));
+  std::memset(match_, 0, sizeof(match_));
+  child_ = 0;
+  descendant_ = 0;
+  accept_ = 1u << query_path_.bytes_.size();
+  for (size_t i = 0; i < query_path_.bytes_.size(); ++i) {
+    uint32_t position = 1u << i;
+    switch (query_path_.types_[i]) {
+    case cas::ByteType::kTypeLabel:
+    case cas::ByteType::kTypePathSeperator:
+      match_[query_path_.bytes_[i]] |= position;
+      break;
+    case cas::ByteType::kTypeWildcard:
+      child_ |= position;
+      break;
+    case cas::ByteType::kTypeDescendant:
+      descendant_ |= position;
+      break;
+    }
+  }
+}
+
+
+cas::PathMatcher::PrefixMatch cas::PathAutomaton::MatchPathIncremental(
+    const std::vector<uint8_t>& path,
+    size_t len_path,
+    cas::PathMatcher::State& s) const {
+  if (bytes_per_label_ == 0) {
+    return MatchSeparated(path, len_path, s);
+  }
+  return MatchSurrogate(path, len_path, s);
+}
+
+
+cas::PathMatcher::PrefixMatch cas::PathAutomaton::MatchSeparated(
+    const std::vector<uint8_t>& path,
+    size_t len_path,
+    cas::PathMatcher::State& s) const {
+  uint32_t active = Active(s);
+  uint32_t inside = Inside(s);
+  if (s.ppos_ == 0 && active == 0 && inside == 0) {
+    active = 1;
+  }
+
+  while (s.ppos_ < len_path) {
+    uint8_t byte = path[s.ppos_];
+    if (byte == cas::kNullByte) {
+      // we reached the end of a full path. a descendant-or-self step
+      // that absorbs labels matches until the end, a child step
+      // matches the empty suffix if the last label is not empty and
+      // descendant-or-self steps match the empty suffix
+      uint32_t end = active | ((inside & descendant_) << 1);
+      if (s.ppos_ > 0 && path[s.ppos_-1] != cas::kPathSep) {
+        end |= (end & child_) << 1;
+      }
+      uint32_t previous;
+      do {
+        previous = end;
+        end |= (end & descendant_) << 1;
+      } while (end != previous);
+      Store(s, active, inside);
+      return (end & accept_) ? PathMatcher::MATCH : PathMatcher::MISMATCH;
+    }
+
+    if (byte == cas::kPathSep) {
+      // child steps end at the separator, which the following query
+      // byte has to consume
+      uint32_t previous;
+      do {
+        previous = active;
+        active |= (active & child_) << 1;
+      } while (active != previous);
+      uint32_t next = ((active & match_[byte]) << 1) |
+        (((active | inside) & descendant_) << 1);
+      inside |= active & descendant_;
+      active = next;
+    } else {
+      active = ((active & match_[byte]) << 1) | (active & child_);
+    }
+    ++s.ppos_;
+
+    if (active == 0 && inside == 0) {
+      Store(s, active, inside);
+      return PathMatcher::MISMATCH;
+    }
+  }
+
+  // we need more input characters to determine the outcome
+  Store(s, active, inside);
+  return PathMatcher::INCOMPLETE;
+}
+
+
+cas::PathMatcher::PrefixMatch cas::PathAutomaton::MatchSurrogate(
+    const std::vector<uint8_t>& path,
+    size_t len_path,
+    cas::PathMatcher::State& s) const {
+  uint32_t active = Active(s);
+  uint32_t inside = Inside(s);
+  if (s.ppos_ == 0 && active == 0 && inside == 0) {
+    active = 1;
+  }
+
+  size_t end = std::min(len_path, nr_bytes_);
+  while (s.ppos_ < end) {
+    CloseDescendants(s.ppos_, active, inside);
+    uint8_t byte = path[s.ppos_];
+    // a child step matches the remaining bytes of the current label
+    bool label_end = (s.ppos_ + 1) % bytes_per_label_ == 0;
+    uint32_t child = active & child_;
+    uint32_t next = ((active & match_[byte]) << 1) |
+      (label_end ? child << 1 : child);
+    if (byte == 0x00) {
+      // trailing 0x00s padded by the surrogate
+      next |= active & accept_;
+    }
+    active = next;
+    ++s.ppos_;
+
+    if (active == 0 && inside == 0) {
+      Store(s, active, inside);
+      return PathMatcher::MISMATCH;
+    }
+  }
+
+  Store(s, active, inside);
+  if (s.ppos_ < nr_bytes_) {
+    // we need more input characters to determine the outcome
+    return PathMatcher::INCOMPLETE;
+  }
+  // a descendant-or-self step may absorb all remaining labels
+  uint32_t matched = active | ((inside & descendant_) << 1);
+  return (matched & accept_) ? PathMatcher::MATCH : PathMatcher::MISMATCH;
+}
+
+
+void cas::PathAutomaton::CloseDescendants(size_t ppos,
+    uint32_t& active, uint32_t& inside) const {
+  if (bytes_per_label_ == 0 || ppos % bytes_per_label_ != 0 ||
+      ppos >= nr_bytes_) {
+    return;
+  }
+  // at a label boundary descendant-or-self steps can be skipped and
+  // steps that absorb labels can end
+  uint32_t previous;
+  do {
+    previous = active;
+    inside |= active & descendant_;
+    active |= ((active | inside) & descendant_) << 1;
+  } while (active != previous);
+}
+
+
+bool cas::PathAutomaton::MatchesAllExtensions(
+    const cas::PathMatcher::State& s) const {
+  if (bytes_per_label_ != 0) {
+    // surrogate paths have a fixed length, the leaves decide
+    return false;
+  }
+  // a trailing descendant-or-self step that absorbs labels matches
+  // every extension
+  return (Inside(s) & descendant_ & (accept_ >> 1)) != 0;
+}
+
+
+bool cas::PathAutomaton::MatchesAnyNextByte(
+    const cas::PathMatcher::State& s) const {
+  uint32_t active = Active(s);
+  uint32_t inside = Inside(s);
+  if (s.ppos_ == 0 && active == 0 && inside == 0) {
+    active = 1;
+  }
+  CloseDescendants(s.ppos_, active, inside);
+  if (inside != 0 || (active & (child_ | descendant_)) != 0) {
+    return true;
+  }
+  // more than one query position is active
+  return (active & (active - 1)) != 0;
+}
+
+
+uint8_t cas::PathAutomaton::NextByte(const cas::PathMatcher::State& s) const {
+  assert(!MatchesAnyNextByte(s));
+  uint32_t active = Active(s);
+  if (s.ppos_ == 0 && active == 0) {
+    active = 1;
+  }
+  if (active & accept_) {
+    // only the terminating null byte (or the padding of surrogate
+    // paths) can follow the complete query
+    return cas::kNullByte;
+  }
+  return query_path_.bytes_[__builtin_ctz(active)];
+}
+
+
+uint32_t cas::PathAutomaton::Active(const cas::PathMatcher::State& s) {
+  return static_cast<uint32_t>(s.nfa_);
+}
+
+
+uint32_t cas::PathAutomaton::Inside(const cas::PathMatcher::State& s) {
+  return static_cast<uint32_t>(s.nfa_ >> 32);
+}
+
+
+void cas::PathAutomaton::Store(cas::PathMatcher::State& s,
+    uint32_t active, uint32_t inside) {
+  s.nfa_ = (static_cast<uint64_t>(inside) << 32) | active;
+}
@@ -1,15 +1,44 @@
 #include "cas/path_matcher.hpp"
+#include "cas/path_automaton.hpp"
 #include "cas/key_encoding.hpp"
 #include "cas/search_key.hpp"
 #include <iostream>
 #include <cassert>
 
 
+cas::PathMatcher::PathMatcher() = default;
+
+
+cas::PathMatcher::~PathMatcher() = default;
+
+
+void cas::PathMatcher::Compile(const cas::BinaryQP& query_path) {
+  automaton_.reset();
+  if (cas::PathAutomaton::Compilable(query_path)) {
+    automaton_.reset(new cas::PathAutomaton(query_path));
+  }
+}
+
+
+const cas::PathAutomaton* cas::PathMatcher::Automaton(
+    const cas::BinaryQP& query_path) const {
+  // the automaton only knows the query path it was compiled from
+  if (automaton_ != nullptr && automaton_->CompiledFrom(query_path)) {
+    return automaton_.get();
+  }
+  return nullptr;
+}
+
+
 cas::PathMatcher::PrefixMatch cas::PathMatcher::MatchPathIncremental(
     const std::vector<uint8_t>& path,
     const cas::BinaryQP& qpath,
     size_t len_path,
     State& s) {
+  const cas::PathAutomaton* automaton = Automaton(qpath);
+  if (automaton != nullptr) {
+    return automaton->MatchPathIncremental(path, len_path, s);
+  }
   const auto& query_path = qpath.bytes_;
   while (s.ppos_ < len_path &&
          s.desc_ppos_ < len_path &&
@@ -89,10 +118,62 @@ bool cas::PathMatcher::MatchPath(
 }
 
 
+bool cas::PathMatcher::MatchesAllExtensions(
+    const cas::BinaryQP& qpath,
+    const State& s) {
+  const cas::PathAutomaton* automaton = Automaton(qpath);
+  if (automaton != nullptr) {
+    return automaton->MatchesAllExtensions(s);
+  }
+  // the descendant-or-self step absorbs any remaining labels and the
+  // terminating null byte then completes the match
+  const auto& query_path = qpath.bytes_;
+  return !query_path.empty() &&
+    s.qpos_ == query_path.size() &&
+    s.desc_qpos_ == static_cast<int16_t>(query_path.size() - 1);
+}
+
+
+bool cas::PathMatcher::MatchesAnyNextByte(
+    const cas::BinaryQP& qpath,
+    const State& s) {
+  const cas::PathAutomaton* automaton = Automaton(qpath);
+  if (automaton != nullptr) {
+    return automaton->MatchesAnyNextByte(s);
+  }
+  if (s.desc_qpos_ != -1) {
+    return true;
+  }
+  if (s.qpos_ >= qpath.types_.size()) {
+    return false;
+  }
+  auto type = qpath.types_[s.qpos_];
+  return type == cas::ByteType::kTypeDescendant ||
+    type == cas::ByteType::kTypeWildcard;
+}
+
+
+uint8_t cas::PathMatcher::NextByte(
+    const cas::BinaryQP& qpath,
+    const State& s) {
+  const cas::PathAutomaton* automaton = Automaton(qpath);
+  if (automaton != nullptr) {
+    return automaton->NextByte(s);
+  }
+  // once the query path is consumed only the terminating null byte of
+  // the path can still match
+  if (s.qpos_ >= qpath.bytes_.size()) {
+    return cas::kNullByte;
+  }
+  return qpath.bytes_[s.qpos_];
+}
+
+
 void cas::PathMatcher::State::Dump() {
   std::cout << "ppos_: " << ppos_ << std::endl;
   std::cout << "qpos_: " << qpos_ << std::endl;
   std::cout << "desc_ppos_: " << desc_ppos_ << std::endl;
   std::cout << "desc_qpos_: " << desc_qpos_ << std::endl;
+  std::cout << "nfa_: " << std::hex << nfa_ << std::dec << std::endl;
 }
 
@@ -0,0 +1,155 @@
+#include "cas/path_summary.hpp"
+#include "cas/key_encoding.hpp"
+#include <algorithm>
+#include <cassert>
+
+
+void cas::PathSummary::Add(const std::vector<uint8_t>& path, size_t nr_keys) {
+  std::vector<std::string> labels;
+  Split(path, labels);
+  Node* node = &root_;
+  for (auto& label : labels) {
+    std::unique_ptr<Node>& child = node->children_[label];
+    if (child == nullptr) {
+      child.reset(new Node());
+    }
+    node = child.get();
+  }
+  if (node->nr_keys_ == 0) {
+    ++nr_paths_;
+  }
+  node->nr_keys_ += nr_keys;
+  nr_keys_ += nr_keys;
+}
+
+
+void cas::PathSummary::Remove(const std::vector<uint8_t>& path, size_t nr_keys) {
+  std::vector<std::string> labels;
+  Split(path, labels);
+  std::vector<Node*> nodes = { &root_ };
+  for (auto& label : labels) {
+    auto it = nodes.back()->children_.find(label);
+    if (it == nodes.back()->children_.end()) {
+      return;
+    }
+    nodes.push_back(it->second.get());
+  }
+  Node* node = nodes.back();
+  nr_keys = std::min(nr_keys, node->nr_keys_);
+  node->nr_keys_ -= nr_keys;
+  nr_keys_ -= nr_keys;
+  if (nr_keys == 0 || node->nr_keys_ > 0) {
+    return;
+  }
+  --nr_paths_;
+  // remove the nodes that no longer lead to a path
+  for (size_t i = labels.size(); i > 0; --i) {
+    Node* current = nodes[i];
+    if (current->nr_keys_ > 0 || !current->children_.empty()) {
+      break;
+    }
+    nodes[i-1]->children_.erase(labels[i-1]);
+  }
+}
+
+
+void cas::PathSummary::Clear() {
+  root_.nr_keys_ = 0;
+  root_.children_.clear();
+  nr_paths_ = 0;
+  nr_keys_ = 0;
+}
+
+
+size_t cas::PathSummary::NrKeys(const std::vector<uint8_t>& path) const {
+  std::vector<std::string> labels;
+  Split(path, labels);
+  const Node* node = &root_;
+  for (auto& label : labels) {
+    auto it = node->children_.find(label);
+    if (it == node->children_.end()) {
+      return 0;
+    }
+    node = it->second.get();
+  }
+  return node->nr_keys_;
+}
+
+
+bool cas::PathSummary::Resolve(const cas::BinaryQP& query_path,
+    cas::PathMatcher& pm, size_t max_paths,
+    std::vector<Path>& paths) const {
+  std::vector<uint8_t> buffer(1, cas::kNullByte);
+  cas::PathMatcher::State state;
+  return Resolve(root_, query_path, pm, max_paths, buffer, 0, state, paths);
+}
+
+
+bool cas::PathSummary::Resolve(const Node& node,
+    const cas::BinaryQP& query_path,
+    cas::PathMatcher& pm,
+    size_t max_paths,
+    std::vector<uint8_t>& buffer,
+    size_t len,
+    const cas::PathMatcher::State& state,
+    std::vector<Path>& paths) const {
+  // buffer holds the path of node, followed by kNullByte
+  if (node.nr_keys_ > 0) {
+    cas::PathMatcher::State end = state;
+    if (pm.MatchPathIncremental(buffer, query_path, len+1, end) ==
+        cas::PathMatcher::MATCH) {
+      if (paths.size() == max_paths) {
+        return false;
+      }
+      paths.push_back(Path{ToQueryPath(buffer, len), node.nr_keys_});
+    }
+  }
+  for (const auto& child : node.children_) {
+    const std::string& label = child.first;
+    size_t child_len = len + 1 + label.size();
+    buffer.resize(child_len + 1);
+    buffer[len] = cas::kPathSep;
+    std::copy(label.begin(), label.end(), buffer.begin() + len + 1);
+    buffer[child_len] = cas::kNullByte;
+    // like Query, the matcher continues from the state of the parent
+    cas::PathMatcher::State child_state = state;
+    if (pm.MatchPathIncremental(buffer, query_path, child_len, child_state) ==
+        cas::PathMatcher::MISMATCH) {
+      continue;
+    }
+    if (!Resolve(*child.second, query_path, pm, max_paths, buffer,
+          child_len, child_state, paths)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+void cas::PathSummary::Split(const std::vector<uint8_t>& path,
+    std::vector<std::string>& labels) {
+  for (uint8_t byte : path) {
+    if (byte == cas::kNullByte) {
+      break;
+    } else if (byte == cas::kPathSep) {
+      labels.emplace_back();
+    } else {
+      assert(!labels.empty());
+      labels.back().push_back(static_cast<char>(byte));
+    }
+  }
+}
+
+
+cas::BinaryQP cas::PathSummary::ToQueryPath(const std::vector<uint8_t>& buffer,
+    size_t len) {
+  cas::BinaryQP query_path;
+  query_path.bytes_.assign(buffer.begin(), buffer.begin() + len);
+  query_path.types_.resize(len);
+  for (size_t i = 0; i < len; ++i) {
+    query_path.types_[i] = buffer[i] == cas::kPathSep
+      ? cas::ByteType::kTypePathSeperator
+      : cas::ByteType::kTypeLabel;
+  }
+  return query_path;
+}
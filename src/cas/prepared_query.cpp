@@ -0,0 +1,34 @@
+#include "cas/prepared_query.hpp"
+#include "cas/key_encoder.hpp"
+
+
+template<class VType>
+cas::PreparedQuery<VType>::PreparedQuery(
+    const cas::path_t& path,
+    cas::Surrogate* surrogate)
+    : surrogate_(surrogate)
+{
+  // the bounds are encoded by every execution
+  cas::SearchKey<VType> key;
+  key.low_ = VType();
+  key.high_ = VType();
+  key.path_ = path;
+  cas::BinarySK bkey;
+  cas::KeyEncoder<VType> encoder;
+  if (surrogate_ != nullptr) {
+    std::vector<uint8_t> label_buffer;
+    encoder.Encode(key, bkey, *surrogate_, label_buffer);
+    pm_.reset(new cas::SurrogatePathMatcher(*surrogate_));
+  } else {
+    encoder.Encode(key, bkey);
+    pm_.reset(new cas::PathMatcher());
+  }
+  path_ = std::move(bkey.path_);
+  pm_->Compile(path_);
+}
+
+
+// explicit instantiations to separate header from implementation
+template class cas::PreparedQuery<cas::vint32_t>;
+template class cas::PreparedQuery<cas::vint64_t>;
+template class cas::PreparedQuery<cas::vstring_t>;
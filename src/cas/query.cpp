@@ -1,10 +1,14 @@
 #include "cas/query.hpp"
+#include "cas/match_buffer.hpp"
 #include "cas/node0.hpp"
+#include "cas/node_dispatch.hpp"
 #include "cas/utils.hpp"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <functional>
 #include <chrono>
+#include <thread>
 
 
 template<class VType>
@@ -14,104 +18,358 @@ cas::Query<VType>::Query(cas::Node* root,
         cas::BinaryKeyEmitter emitter)
     : root_(root)
     , key_(key)
+    , query_path_(&key.path_)
     , pm_(pm)
     , emitter_(emitter)
-    , buf_pat_(cas::kMaxPathLength+1, 0x00)
-    , buf_val_(cas::kMaxValueLength+1, 0x00)
+    , own_context_(new cas::QueryContext())
+    , context_(*own_context_)
+    , buf_pat_(own_context_->buf_pat_)
+    , buf_val_(own_context_->buf_val_)
+    , stack_(own_context_->stack_)
+    , auxiliary_index_(nullptr)
+{}
+
+
+template<class VType>
+cas::Query<VType>::Query(cas::Node* root,
+        cas::BinarySK& key,
+        cas::PathMatcher& pm,
+        cas::BinaryKeyEmitter emitter,
+        cas::QueryContext& context)
+    : root_(root)
+    , key_(key)
+    , query_path_(&key.path_)
+    , pm_(pm)
+    , emitter_(std::move(emitter))
+    , context_(context)
+    , buf_pat_(context.buf_pat_)
+    , buf_val_(context.buf_val_)
+    , stack_(context.stack_)
     , auxiliary_index_(nullptr)
 {}
 
 
 template<class VType>
 void cas::Query<VType>::Execute() {
-  if (root_ == nullptr) {
+  if (concurrent_auxiliary_ && auxiliary_index_ != nullptr) {
+    ExecuteConcurrently();
     return;
   }
+  cas::Node0* leaf;
+  while ((leaf = NextLeaf()) != nullptr) {
+    EmitMatch(leaf);
+  }
+}
 
-  const auto& t_start_main = std::chrono::high_resolution_clock::now();
 
-  State initial_state;
-  initial_state.node_ = root_;
-  initial_state.parent_type_ = cas::NodeType::Path; // doesn't matter
-  initial_state.parent_byte_ = 0x00; // doesn't matter;
-  initial_state.len_pat_ = 0;
-  initial_state.len_val_ = 0;
-  initial_state.vl_pos_ = 0;
-  initial_state.vh_pos_ = 0;
-  stack_.push_back(initial_state);
+template<class VType>
+void cas::Query<VType>::ExecuteConcurrently() {
+  t_start_ = std::chrono::high_resolution_clock::now();
+
+  // the auxiliary index is searched with the buffers of the auxiliary
+  // context, which our context keeps between queries; the matcher only
+  // keeps its state in the traversal State and can be shared
+  cas::Query<VType> aux_query(auxiliary_index_, key_, pm_,
+      cas::BinaryKeyEmitter(), context_.Auxiliary());
+  aux_query.setQueryPath(*query_path_);
+  aux_query.setPrefetchDistance(prefetch_distance_);
+  cas::MatchBuffer aux_matches;
+  std::thread aux_thread([&]() {
+    cas::Node0* leaf;
+    while ((leaf = aux_query.NextLeaf()) != nullptr) {
+      aux_matches.Append(aux_query.BufferPath(), aux_query.LeafPathLength(),
+          aux_query.BufferValue(), aux_query.LeafValueLength(), *leaf);
+    }
+  });
 
-  while (!stack_.empty()) {
-    State s = stack_.back();
-    stack_.pop_back();
-
-    UpdateStats(s);
-    PrepareBuffer(s);
-    cas::PathMatcher::PrefixMatch match_pat = MatchPathPrefix(s);
-    cas::PathMatcher::PrefixMatch match_val = MatchValuePrefix(s);
-
-    if (match_pat == PathMatcher::MATCH &&
-        match_val == PathMatcher::MATCH) {
-      assert(s.node_->IsLeaf());
-      EmitMatch(s);
-    } else if (match_pat != PathMatcher::MISMATCH &&
-               match_val != PathMatcher::MISMATCH) {
-      assert(!s.node_->IsLeaf());
-      Descend(s);
+  ResetBuffers();
+  Push(root_);
+  phase_ = Phase::kTask;
+  try {
+    cas::Node0* leaf;
+    while ((leaf = NextLeaf()) != nullptr) {
+      EmitMatch(leaf);
     }
+  } catch (...) {
+    // a joinable thread must not be destroyed during unwinding
+    aux_thread.join();
+    throw;
   }
-
   const auto& t_end_main = std::chrono::high_resolution_clock::now();
+
+  aux_thread.join();
+  if (span_emitter_) {
+    stats_.nr_matches_ += aux_matches.Emit(span_emitter_);
+  } else {
+    stats_.nr_matches_ += aux_matches.Emit(emitter_);
+  }
+  phase_ = Phase::kDone;
+
+  const cas::QueryStats& aux_stats = aux_query.Stats();
+  stats_.read_path_nodes_  += aux_stats.read_path_nodes_;
+  stats_.read_value_nodes_ += aux_stats.read_value_nodes_;
+  const auto& t_end = std::chrono::high_resolution_clock::now();
   stats_.runtime_main_mus_ =
-    std::chrono::duration_cast<std::chrono::microseconds>(t_end_main-t_start_main).count();
+    std::chrono::duration_cast<std::chrono::microseconds>(t_end_main-t_start_).count();
+  // aux_query traverses the auxiliary index as its main index
+  stats_.runtime_aux_mus_ = aux_stats.runtime_main_mus_;
+  stats_.runtime_mus_ =
+    std::chrono::duration_cast<std::chrono::microseconds>(t_end-t_start_).count();
+}
+
+
+template<class VType>
+cas::Node0* cas::Query<VType>::NextLeaf() {
+  if (phase_ == Phase::kStart) {
+    t_start_ = std::chrono::high_resolution_clock::now();
+    t_phase_ = t_start_;
+    ResetBuffers();
+    Push(root_);
+    phase_ = Phase::kMain;
+  }
+
+  for (;;) {
+    while (stack_.empty()) {
+      const auto& t_now = std::chrono::high_resolution_clock::now();
+      switch (phase_) {
+      case Phase::kMain: {
+        stats_.runtime_main_mus_ =
+          std::chrono::duration_cast<std::chrono::microseconds>(t_now-t_phase_).count();
+        t_phase_ = t_now;
+        phase_ = Phase::kAux;
+        if (auxiliary_index_ != nullptr) {
+          ResetBuffers();
+          Push(auxiliary_index_);
+        }
+        break;
+      }
+      case Phase::kAux:
+        stats_.runtime_aux_mus_ =
+          std::chrono::duration_cast<std::chrono::microseconds>(t_now-t_phase_).count();
+        stats_.runtime_mus_ =
+          std::chrono::duration_cast<std::chrono::microseconds>(t_now-t_start_).count();
+        phase_ = Phase::kDone;
+        return nullptr;
+      case Phase::kStart:
+      case Phase::kTask:
+      case Phase::kDone:
+        return nullptr;
+      }
+    }
+
+    cas::Node0* leaf = Visit();
+    if (leaf != nullptr) {
+      return leaf;
+    }
+  }
+}
+
+
+template<class VType>
+cas::Node0* cas::Query<VType>::Visit() {
+  State s = stack_.back();
+  stack_.pop_back();
+  PrefetchPending();
+
+  UpdateStats(s);
+  PrepareBuffer(s);
+  cas::PathMatcher::PrefixMatch match_pat = MatchPathPrefix(s);
+  cas::PathMatcher::PrefixMatch match_val = MatchValuePrefix(s);
+
+  if (match_pat == PathMatcher::MATCH &&
+      match_val == PathMatcher::MATCH) {
+    assert(s.node_->IsLeaf());
+    leaf_len_pat_ = s.len_pat_;
+    leaf_len_val_ = s.len_val_;
+    return static_cast<cas::Node0*>(s.node_);
+  } else if (match_pat != PathMatcher::MISMATCH &&
+             match_val != PathMatcher::MISMATCH) {
+    assert(!s.node_->IsLeaf());
+    if (count_subtrees_ && IsContained(s, match_pat, match_val)) {
+      nr_counted_ += s.node_->nr_keys_;
+    } else if (s.depth_ >= max_depth_ ||
+        static_cast<size_t>(stats_.read_path_nodes_ +
+          stats_.read_value_nodes_) >= max_nodes_) {
+      EstimateSubtree(s);
+    } else {
+      Descend(s);
+    }
+  }
+  return nullptr;
+}
+
+
+template<class VType>
+void cas::Query<VType>::Resume(const cas::QueryTask& task) {
+  phase_ = Phase::kTask;
+  traversal_root_ = task.root_;
+  std::copy(task.path_.begin(), task.path_.end(), buf_pat_.begin());
+  std::copy(task.value_.begin(), task.value_.end(), buf_val_.begin());
+  stack_.clear();
+  stack_.push_back(task.state_);
+  prefix_pending_ = nullptr;
+  prefix_from_ = 0;
+}
+
+
+template<class VType>
+bool cas::Query<VType>::Split(cas::QueryTask& task) {
+  if (stack_.size() < 2) {
+    return false;
+  }
+  // the bytes up to the state's lengths were written by its ancestors,
+  // which all lie on the path to the node visited last
+  MakeTask(stack_.front(), task);
+  stack_.erase(stack_.begin());
+  return true;
+}
+
+
+template<class VType>
+cas::Node0* cas::Query<VType>::Expand(const cas::QueryTask& task,
+    std::vector<cas::QueryTask>& children) {
+  Resume(task);
+  cas::Node0* leaf = Visit();
+  for (const State& s : stack_) {
+    children.emplace_back();
+    MakeTask(s, children.back());
+  }
+  stack_.clear();
+  return leaf;
+}
+
+
+template<class VType>
+void cas::Query<VType>::MakeTask(const State& s, cas::QueryTask& task) {
+  task.root_ = traversal_root_;
+  task.state_ = s;
+  task.path_.assign(buf_pat_.begin(), buf_pat_.begin() + s.len_pat_);
+  task.value_.assign(buf_val_.begin(), buf_val_.begin() + s.len_val_);
+}
+
+
+template<class VType>
+uint64_t cas::Query<VType>::Count() {
+  count_subtrees_ = true;
+  uint64_t count = 0;
+  cas::Node0* leaf;
+  while ((leaf = NextLeaf()) != nullptr) {
+    count += leaf->dids_.size();
+  }
+  count += nr_counted_;
+  stats_.nr_matches_ = static_cast<int32_t>(count);
+  return count;
+}
+
+
+template<class VType>
+cas::CardinalityEstimate cas::Query<VType>::Estimate(
+    size_t max_depth, size_t max_nodes) {
+  count_subtrees_ = true;
+  max_depth_ = max_depth;
+  max_nodes_ = max_nodes;
+  uint64_t exact = 0;
+  cas::Node0* leaf;
+  while ((leaf = NextLeaf()) != nullptr) {
+    exact += leaf->dids_.size();
+  }
+  exact += nr_counted_;
+
+  cas::CardinalityEstimate estimate;
+  estimate.lower_ = exact;
+  estimate.upper_ = exact + estimated_upper_;
+  estimate.estimate_ = exact + estimated_keys_;
+  estimate.read_nodes_ = stats_.read_path_nodes_ + stats_.read_value_nodes_;
+  estimate.runtime_mus_ = stats_.runtime_mus_;
+  return estimate;
+}
+
+
+template<class VType>
+void cas::Query<VType>::EstimateSubtree(State& s) {
+  // the fraction of the children that the query would descend into
+  // scales the keys of the subtree; the other dimension is assumed
+  // to match
+  size_t nr_candidates = 0;
+  switch (s.node_->type_) {
+  case cas::NodeType::Path:
+    if (DescendsAllPathChildren(s)) {
+      nr_candidates = s.node_->nr_children_;
+    } else if (cas::NodeDispatch::LocateChild(s.node_, NextPathByte(s)) != nullptr) {
+      nr_candidates = 1;
+    }
+    break;
+  case cas::NodeType::Value: {
+    uint8_t low, high;
+    ValueByteRange(s, low, high);
+    cas::NodeDispatch::ForEachChild(s.node_, low, high,
+        [&](uint8_t, cas::Node&) -> bool {
+      ++nr_candidates;
+      return true;
+    });
+    break;
+  }
+  case cas::NodeType::Leaf:
+    assert(false);
+    break;
+  }
+  if (nr_candidates == 0) {
+    return;
+  }
+  estimated_upper_ += s.node_->nr_keys_;
+  estimated_keys_ += static_cast<double>(s.node_->nr_keys_) *
+    nr_candidates / s.node_->nr_children_;
+}
 
-  const auto& t_start_aux = std::chrono::high_resolution_clock::now();
 
-  // Use of Auxiliary index case
-  if(auxiliary_index_ != nullptr){
+template<class VType>
+bool cas::Query<VType>::IsContained(State& s,
+    PathMatcher::PrefixMatch match_pat,
+    PathMatcher::PrefixMatch match_val) {
+  if (match_pat != PathMatcher::MATCH &&
+      !pm_.MatchesAllExtensions(*query_path_, s.pm_state_)) {
+    return false;
+  }
+  if (match_val == PathMatcher::MATCH) {
+    return true;
+  }
+  // a value that differs from key_.low_ at vl_pos_ is larger, one
+  // that agrees with it so far is not smaller if key_.low_ continues
+  // with the smallest bytes only (and likewise for key_.high_)
+  if (s.vl_pos_ == s.len_val_) {
+    for (size_t i = s.vl_pos_; i < key_.low_.size(); ++i) {
+      if (key_.low_[i] != 0x00) {
+        return false;
+      }
+    }
+  }
+  if (s.vh_pos_ == s.len_val_) {
+    for (size_t i = s.vh_pos_; i < key_.high_.size(); ++i) {
+      if (key_.high_[i] != 0xFF) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 
-  cas::PathMatcher pm_new;
-  pm_ = pm_new;
+template<class VType>
+void cas::Query<VType>::Push(cas::Node* root) {
+  if (root == nullptr) {
+    return;
+  }
+  traversal_root_ = root;
   State initial_state;
-  initial_state.node_ = auxiliary_index_;
+  initial_state.node_ = root;
   initial_state.parent_type_ = cas::NodeType::Path; // doesn't matter
   initial_state.parent_byte_ = 0x00; // doesn't matter;
   initial_state.len_pat_ = 0;
   initial_state.len_val_ = 0;
   initial_state.vl_pos_ = 0;
   initial_state.vh_pos_ = 0;
-  stack_.clear();
+  initial_state.depth_ = 0;
   stack_.push_back(initial_state);
-
-  buf_pat_ = std::vector<uint8_t>(cas::kMaxPathLength+1, 0x00);
-  buf_val_ = std::vector<uint8_t>(cas::kMaxValueLength+1, 0x00);
-
-  while (!stack_.empty()) {
-    State s = stack_.back();
-    stack_.pop_back();
-    UpdateStats(s);
-    PrepareBufferAuxiliaryIndex(s);
-    cas::PathMatcher::PrefixMatch match_pat = MatchPathPrefix(s);
-    cas::PathMatcher::PrefixMatch match_val = MatchValuePrefix(s);
-
-    if (match_pat == PathMatcher::MATCH &&
-        match_val == PathMatcher::MATCH) {
-      assert(s.node_->IsLeaf());
-
-      EmitMatch(s);
-    } else if (match_pat != PathMatcher::MISMATCH &&
-               match_val != PathMatcher::MISMATCH) {
-      assert(!s.node_->IsLeaf());
-      Descend(s);
-    }
-  }
-  }
-
-  const auto& t_end_aux = std::chrono::high_resolution_clock::now();
-  stats_.runtime_aux_mus_ =
-    std::chrono::duration_cast<std::chrono::microseconds>(t_end_aux-t_start_aux).count();
-
-  stats_.runtime_mus_ =
-    std::chrono::duration_cast<std::chrono::microseconds>(t_end_aux-t_start_main).count();
 }
 
 
@@ -130,9 +388,21 @@ void cas::Query<VType>::UpdateStats(State& s) {
 }
 
 
+template<class VType>
+void cas::Query<VType>::ResetBuffers() {
+  // the emitters decode the buffers up to the first null byte, so the
+  // bytes of an earlier traversal must not survive
+  std::fill(buf_pat_.begin(), buf_pat_.end(), 0x00);
+  std::fill(buf_val_.begin(), buf_val_.end(), 0x00);
+  stack_.clear();
+  prefix_pending_ = nullptr;
+  prefix_from_ = 0;
+}
+
+
 template<class VType>
 void cas::Query<VType>::PrepareBuffer(State& s) {
-  if (s.node_ != root_) {
+  if (s.node_ != traversal_root_) {
     switch (s.parent_type_) {
     case cas::NodeType::Path:
       buf_pat_[s.len_pat_] = s.parent_byte_;
@@ -158,38 +428,10 @@ void cas::Query<VType>::PrepareBuffer(State& s) {
 }
 
 
-template<class VType>
-void cas::Query<VType>::PrepareBufferAuxiliaryIndex(State &s) {
-    if (s.node_ != auxiliary_index_) {
-        switch (s.parent_type_) {
-            case cas::NodeType::Path:
-                buf_pat_[s.len_pat_] = s.parent_byte_;
-                ++s.len_pat_;
-                break;
-            case cas::NodeType::Value:
-                buf_val_[s.len_val_] = s.parent_byte_;
-                ++s.len_val_;
-                break;
-            case cas::NodeType::Leaf:
-                assert(false);
-                break;
-        }
-    }
-    size_t node_pat_len = s.node_->separator_pos_;
-    size_t node_val_len = s.node_->prefix_.size() - s.node_->separator_pos_;
-    std::memcpy(&buf_pat_[s.len_pat_], &s.node_->prefix_[0],
-                node_pat_len);
-    std::memcpy(&buf_val_[s.len_val_], &s.node_->prefix_[s.node_->separator_pos_],
-                node_val_len);
-    s.len_pat_ += node_pat_len;
-    s.len_val_ += node_val_len;
-}
-
-
 template<class VType>
 cas::PathMatcher::PrefixMatch
 cas::Query<VType>::MatchPathPrefix(State& s) {
-  return pm_.MatchPathIncremental(buf_pat_, key_.path_,
+  return pm_.MatchPathIncremental(buf_pat_, *query_path_,
       s.len_pat_, s.pm_state_);
 }
 
@@ -260,13 +502,31 @@ void cas::Query<VType>::Descend(State& s) {
 }
 
 
+template<class VType>
+bool cas::Query<VType>::DescendsAllPathChildren(State& s) {
+  return pm_.MatchesAnyNextByte(*query_path_, s.pm_state_);
+}
+
+
+template<class VType>
+uint8_t cas::Query<VType>::NextPathByte(State& s) {
+  return pm_.NextByte(*query_path_, s.pm_state_);
+}
+
+
+template<class VType>
+void cas::Query<VType>::ValueByteRange(State& s, uint8_t& low, uint8_t& high) {
+  low  = (s.vl_pos_ == s.len_val_) ? key_.low_[s.vl_pos_]  : 0x00;
+  high = (s.vh_pos_ == s.len_val_) ? key_.high_[s.vh_pos_] : 0xFF;
+}
+
+
 template<class VType>
 void cas::Query<VType>::DescendPathNode(State& s) {
-  if (s.pm_state_.desc_qpos_ != -1 ||
-      key_.path_.types_[s.pm_state_.qpos_] == cas::ByteType::kTypeDescendant ||
-      key_.path_.types_[s.pm_state_.qpos_] == cas::ByteType::kTypeWildcard) {
+  if (DescendsAllPathChildren(s)) {
     // descend all children of s.node_
-    s.node_->ForEachChild([&](uint8_t byte, cas::Node& child) -> bool {
+    size_t nr_pushed = 0;
+    cas::NodeDispatch::ForEachChild(s.node_, [&](uint8_t byte, cas::Node& child) -> bool {
       stack_.push_back({
         .node_        = &child,
         .parent_type_ = s.node_->type_,
@@ -276,13 +536,16 @@ void cas::Query<VType>::DescendPathNode(State& s) {
         .pm_state_    = s.pm_state_,
         .vl_pos_      = s.vl_pos_,
         .vh_pos_      = s.vh_pos_,
+        .depth_       = static_cast<uint16_t>(s.depth_ + 1),
       });
+      ++nr_pushed;
       return true;
     });
+    PrefetchPushed(nr_pushed);
   } else {
     // we are looking for exactly one child
-    uint8_t byte = key_.path_.bytes_[s.pm_state_.qpos_];
-    cas::Node* child = s.node_->LocateChild(byte);
+    uint8_t byte = NextPathByte(s);
+    cas::Node* child = cas::NodeDispatch::LocateChild(s.node_, byte);
     if (child != nullptr) {
       stack_.push_back({
         .node_        = child,
@@ -293,6 +556,7 @@ void cas::Query<VType>::DescendPathNode(State& s) {
         .pm_state_    = s.pm_state_,
         .vl_pos_      = s.vl_pos_,
         .vh_pos_      = s.vh_pos_,
+        .depth_       = static_cast<uint16_t>(s.depth_ + 1),
       });
     }
   }
@@ -301,9 +565,11 @@ void cas::Query<VType>::DescendPathNode(State& s) {
 
 template<class VType>
 void cas::Query<VType>::DescendValueNode(State& s) {
-  uint8_t low  = (s.vl_pos_ == s.len_val_) ? key_.low_[s.vl_pos_]  : 0x00;
-  uint8_t high = (s.vh_pos_ == s.len_val_) ? key_.high_[s.vh_pos_] : 0xFF;
-  s.node_->ForEachChild(low, high, [&](uint8_t byte, cas::Node& child) -> bool {
+  uint8_t low, high;
+  ValueByteRange(s, low, high);
+  size_t nr_pushed = 0;
+  cas::NodeDispatch::ForEachChild(s.node_, low, high,
+      [&](uint8_t byte, cas::Node& child) -> bool {
     stack_.push_back({
       .node_        = &child,
       .parent_type_ = s.node_->type_,
@@ -313,43 +579,62 @@ void cas::Query<VType>::DescendValueNode(State& s) {
       .pm_state_    = s.pm_state_,
       .vl_pos_      = s.vl_pos_,
       .vh_pos_      = s.vh_pos_,
+      .depth_       = static_cast<uint16_t>(s.depth_ + 1),
     });
+    ++nr_pushed;
     return true;
   });
+  PrefetchPushed(nr_pushed);
 }
 
 
 template<class VType>
-void cas::Query<VType>::EmitMatch(State& s) {
-  assert(s.node_->IsLeaf());
-  cas::Node0* leaf = static_cast<cas::Node0*>(s.node_);
-  for (cas::did_t& did : leaf->dids_) {
-    ++stats_.nr_matches_;
-    emitter_(buf_pat_, buf_val_, did);
+void cas::Query<VType>::PrefetchPushed(size_t nr_pushed) {
+  // the children pushed last are visited first; the others are
+  // prefetched once they move up to the prefetch distance
+  size_t nr_prefetched = std::min(nr_pushed, prefetch_distance_);
+  prefix_from_ = stack_.size() - nr_prefetched;
+  for (size_t i = prefix_from_; i < stack_.size(); ++i) {
+    __builtin_prefetch(stack_[i].node_);
   }
 }
 
 
 template<class VType>
-void cas::Query<VType>::State::Dump() {
-  std::cout << "node: " << node_ << std::endl;
-  switch (parent_type_) {
-  case cas::NodeType::Path:
-    std::cout << "parent_type_: Path" << std::endl;
-    break;
-  case cas::NodeType::Value:
-    std::cout << "parent_type_: Value" << std::endl;
-    break;
-  case cas::NodeType::Leaf:
-    assert(false);
-    break;
+void cas::Query<VType>::PrefetchPending() {
+  if (prefetch_distance_ == 0) {
+    return;
+  }
+  // the headers requested on the previous visit have arrived by now,
+  // so a spilled prefix can be located without a blocking miss
+  if (prefix_pending_ != nullptr) {
+    prefix_pending_->prefix_.Prefetch();
+    prefix_pending_ = nullptr;
+  }
+  for (size_t i = prefix_from_; i < stack_.size(); ++i) {
+    stack_[i].node_->prefix_.Prefetch();
+  }
+  prefix_from_ = stack_.size();
+  if (stack_.size() < prefetch_distance_) {
+    return;
+  }
+  // the node that just moved up to the prefetch distance
+  prefix_pending_ = stack_[stack_.size() - prefetch_distance_].node_;
+  __builtin_prefetch(prefix_pending_);
+}
+
+
+template<class VType>
+void cas::Query<VType>::EmitMatch(cas::Node0* leaf) {
+  if (span_emitter_) {
+    stats_.nr_matches_ += leaf->dids_.size();
+    span_emitter_(buf_pat_, buf_val_, leaf->dids_);
+    return;
+  }
+  for (cas::did_t did : leaf->dids_) {
+    ++stats_.nr_matches_;
+    emitter_(buf_pat_, buf_val_, did);
   }
-  printf("parent_byte_: 0x%02X\n", (unsigned char) parent_byte_);
-  std::cout << "len_val_: " << len_val_ << std::endl;
-  std::cout << "len_pat_: " << len_pat_ << std::endl;
-  pm_state_.Dump();
-  std::cout << "vl_pos_: " << vl_pos_ << std::endl;
-  std::cout << "vh_pos_: " << vh_pos_ << std::endl;
 }
 
 
@@ -369,11 +654,35 @@ void cas::Query<VType>::DumpState(State& s) {
   std::cout << std::endl;
 }
 
+template<class VType>
+void cas::Query<VType>::setConcurrentAuxiliary(bool concurrent) {
+  concurrent_auxiliary_ = concurrent;
+}
+
+
+template<class VType>
+void cas::Query<VType>::setDidSpanEmitter(cas::DidSpanEmitter emitter) {
+  span_emitter_ = std::move(emitter);
+}
+
+
+template<class VType>
+void cas::Query<VType>::setPrefetchDistance(size_t distance) {
+  prefetch_distance_ = distance;
+}
+
+
 template<class VType>
 void cas::Query<VType>::setAuxiliaryIndex(cas::Node *node) {
     auxiliary_index_ = node;
 }
 
+
+template<class VType>
+void cas::Query<VType>::setQueryPath(const cas::BinaryQP& query_path) {
+  query_path_ = &query_path;
+}
+
 // explicit instantiations to separate header from implementation
 template class cas::Query<cas::vint32_t>;
 template class cas::Query<cas::vint64_t>;
@@ -0,0 +1,59 @@
+#include "cas/query_context.hpp"
+#include "cas/key_encoding.hpp"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+
+
+cas::QueryContext::QueryContext()
+    : buf_pat_(cas::kMaxPathLength+1, 0x00)
+    , buf_val_(cas::kMaxValueLength+1, 0x00)
+{
+  stack_.reserve(64);
+}
+
+
+cas::QueryContext& cas::QueryContext::ForThisThread() {
+  static thread_local cas::QueryContext context;
+  return context;
+}
+
+
+cas::QueryContext& cas::QueryContext::Auxiliary() {
+  if (auxiliary_ == nullptr) {
+    auxiliary_.reset(new cas::QueryContext());
+  }
+  return *auxiliary_;
+}
+
+
+cas::QueryContext::Lease::Lease()
+    : context_(&cas::QueryContext::ForThisThread()) {
+  if (context_->in_use_) {
+    nested_.reset(new cas::QueryContext());
+    context_ = nested_.get();
+  }
+}
+
+
+void cas::QueryState::Dump() {
+  std::cout << "node: " << node_ << std::endl;
+  switch (parent_type_) {
+  case cas::NodeType::Path:
+    std::cout << "parent_type_: Path" << std::endl;
+    break;
+  case cas::NodeType::Value:
+    std::cout << "parent_type_: Value" << std::endl;
+    break;
+  case cas::NodeType::Leaf:
+    assert(false);
+    break;
+  }
+  printf("parent_byte_: 0x%02X\n", (unsigned char) parent_byte_);
+  std::cout << "len_val_: " << len_val_ << std::endl;
+  std::cout << "len_pat_: " << len_pat_ << std::endl;
+  pm_state_.Dump();
+  std::cout << "vl_pos_: " << vl_pos_ << std::endl;
+  std::cout << "vh_pos_: " << vh_pos_ << std::endl;
+  std::cout << "depth_: " << depth_ << std::endl;
+}
@@ -0,0 +1,78 @@
+#include "cas/query_cursor.hpp"
+#include "cas/key_encoder.hpp"
+
+
+template<class VType>
+cas::QueryCursor<VType>::QueryCursor(
+    cas::Node* root,
+    cas::Node* auxiliary_index,
+    cas::SearchKey<VType>& key,
+    cas::Surrogate* surrogate)
+    : context_(new cas::QueryContext())
+    , surrogate_(surrogate)
+{
+  cas::KeyEncoder<VType> encoder;
+  if (surrogate_ != nullptr) {
+    encoder.Encode(key, context_->key_, *surrogate_, context_->label_);
+    pm_.reset(new cas::SurrogatePathMatcher(*surrogate_));
+  } else {
+    encoder.Encode(key, context_->key_);
+    pm_.reset(new cas::PathMatcher());
+  }
+  pm_->Compile(context_->key_.path_);
+  query_.reset(new cas::Query<VType>(root, context_->key_, *pm_,
+        cas::BinaryKeyEmitter(), *context_));
+  if (surrogate_ == nullptr) {
+    // like Cas::Query, the surrogate index only has a main index
+    query_->setAuxiliaryIndex(auxiliary_index);
+  }
+}
+
+
+template<class VType>
+cas::QueryCursor<VType>& cas::QueryCursor<VType>::Limit(size_t n) {
+  limit_ = nr_matches_ + n;
+  return *this;
+}
+
+
+template<class VType>
+bool cas::QueryCursor<VType>::Next() {
+  if (nr_matches_ >= limit_) {
+    return false;
+  }
+  while (leaf_ == nullptr || did_it_ == leaf_->dids_.end()) {
+    leaf_ = query_->NextLeaf();
+    if (leaf_ == nullptr) {
+      return false;
+    }
+    did_it_ = leaf_->dids_.begin();
+  }
+  did_ = *did_it_;
+  ++did_it_;
+  ++nr_matches_;
+  return true;
+}
+
+
+template<class VType>
+cas::Key<VType> cas::QueryCursor<VType>::Current() {
+  if (surrogate_ != nullptr) {
+    return decoder_.Decode(*surrogate_, BufferPath(), BufferValue(), did_);
+  }
+  return decoder_.Decode(BufferPath(), BufferValue(), did_);
+}
+
+
+template<class VType>
+cas::QueryStats cas::QueryCursor<VType>::Stats() const {
+  cas::QueryStats stats = query_->Stats();
+  stats.nr_matches_ = nr_matches_;
+  return stats;
+}
+
+
+// explicit instantiations to separate header from implementation
+template class cas::QueryCursor<cas::vint32_t>;
+template class cas::QueryCursor<cas::vint64_t>;
+template class cas::QueryCursor<cas::vstring_t>;
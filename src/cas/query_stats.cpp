@@ -17,6 +17,18 @@ void cas::QueryStats::Dump() const {
 }
 
 
+void cas::ConjunctiveQueryStats::Dump() const {
+  std::cout << "ConjunctiveQueryStats" << std::endl;
+  std::cout << "Matches: " << nr_matches_ << std::endl;
+  std::cout << "Runtime (mus): " << runtime_mus_ << std::endl;
+  for (size_t i = 0; i < order_.size(); ++i) {
+    std::cout << "Predicate " << order_[i] << " (candidates left: "
+      << nr_candidates_[i] << ")" << std::endl;
+    predicates_[order_[i]].Dump();
+  }
+}
+
+
 cas::QueryStats cas::QueryStats::Avg(const std::vector<cas::QueryStats>& stats) {
   cas::QueryStats result;
   int32_t nr_insert_time_main = 1;
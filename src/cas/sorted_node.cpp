@@ -0,0 +1,96 @@
+#include "cas/sorted_node.hpp"
+#include "cas/node_allocator.hpp"
+#include <cassert>
+#include <iostream>
+
+
+template<int N>
+cas::SortedNode<N>::SortedNode(cas::NodeType type)
+    : cas::Node(type, N) {
+  memset(keys_, 0, N*sizeof(uint8_t));
+  memset(children_, 0, N*sizeof(ChildRef));
+}
+
+
+template<int N>
+void cas::SortedNode<N>::Put(uint8_t key_byte, Node* child) {
+  // callers grow full nodes first
+  assert(nr_children_ < N);
+  int pos = 0;
+  while (pos < nr_children_ && key_byte > keys_[pos]) {
+    ++pos;
+  }
+  std::memmove(keys_+pos+1, keys_+pos, (nr_children_-pos)*sizeof(uint8_t));
+  std::memmove(children_+pos+1, children_+pos, (nr_children_-pos)*sizeof(ChildRef));
+  keys_[pos] = key_byte;
+  children_[pos] = child;
+  ++nr_children_;
+}
+
+
+template<int N>
+void cas::SortedNode<N>::DeleteNode(uint8_t key_byte) {
+  int pos = KeySearch::Find<N>(keys_, nr_children_, key_byte);
+  // callers only delete children they located before
+  assert(pos >= 0);
+  --nr_children_;
+  std::memmove(keys_+pos, keys_+pos+1, (nr_children_-pos)*sizeof(uint8_t));
+  std::memmove(children_+pos, children_+pos+1, (nr_children_-pos)*sizeof(ChildRef));
+  memset(keys_+nr_children_, 0, (N-nr_children_)*sizeof(uint8_t));
+  memset(children_+nr_children_, 0, (N-nr_children_)*sizeof(ChildRef));
+}
+
+
+template<int N>
+std::vector<uint8_t> cas::SortedNode<N>::GetKeys() {
+  return std::vector<uint8_t>(keys_, keys_ + nr_children_);
+}
+
+
+template<int N>
+void cas::SortedNode<N>::ReplaceBytePointer(uint8_t key_byte, cas::Node* child) {
+  int pos = KeySearch::Find<N>(keys_, nr_children_, key_byte);
+  assert(pos >= 0);
+  children_[pos] = child;
+}
+
+
+template<int N>
+bool cas::SortedNode<N>::ForEachChild(uint8_t low, uint8_t high,
+                                      cas::ChildIt callback) {
+  return VisitChildren(low, high, callback);
+}
+
+
+template<int N>
+bool cas::SortedNode<N>::IsFull() {
+  return nr_children_ >= N;
+}
+
+
+template<int N>
+size_t cas::SortedNode<N>::SizeBytes() {
+  return cas::NodeAllocator::InnerBlockBytes(sizeof(cas::SortedNode<N>)) +
+    prefix_.HeapBytes();
+}
+
+
+template<int N>
+void cas::SortedNode<N>::Dump() {
+  std::cout << "type: Node" << N << std::endl;
+  cas::Node::Dump();
+  std::cout << "keys_: ";
+  DumpBuffer(keys_, N);
+  std::cout << std::endl;
+  std::cout << "children_: ";
+  DumpAddresses(children_, N);
+  std::cout << std::endl;
+  std::cout << std::endl;
+}
+
+
+// explicit instantiations to separate header from implementation
+template class cas::SortedNode<4>;
+template class cas::SortedNode<8>;
+template class cas::SortedNode<16>;
+template class cas::SortedNode<32>;
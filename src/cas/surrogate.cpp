@@ -9,6 +9,16 @@ cas::Surrogate::Surrogate(size_t max_depth, size_t bytes_per_label)
 
 
 std::vector<uint8_t> cas::Surrogate::MapLabel(const std::string& label) {
+  std::vector<uint8_t> bytes;
+  MapLabel(label, 0, label.size(), bytes);
+  return bytes;
+};
+
+
+void cas::Surrogate::MapLabel(const std::string& text, size_t pos,
+    size_t size, std::vector<uint8_t>& bytes) {
+  // short labels fit into the string's inline buffer
+  std::string label(text, pos, size);
   uint32_t surrogate;
   auto it = map_.find(label);
   if (it == map_.end()) {
@@ -19,16 +29,11 @@ std::vector<uint8_t> cas::Surrogate::MapLabel(const std::string& label) {
     surrogate = it->second;
   }
 
-  int pos = 0;
-  std::vector<uint8_t> bytes(bytes_per_label_, 0x00);
   for (int i = bytes_per_label_-1; i >= 0; --i) {
     // extract the i-th byte from the surrogate
-    bytes[pos] = (surrogate >> (i * 8)) & 0xFF;
-    ++pos;
+    bytes.push_back((surrogate >> (i * 8)) & 0xFF);
   }
-
-  return bytes;
-};
+}
 
 
 std::vector<uint8_t> cas::Surrogate::MapPath(const std::vector<std::string>& path) {
@@ -53,6 +58,16 @@ size_t cas::Surrogate::NrBytes() const {
 
 
 std::string cas::Surrogate::MapLabelInv(const std::vector<uint8_t>& bytes) {
+  const std::string* label = FindLabel(&bytes[0]);
+  if (label == nullptr) {
+    return "";
+  } else {
+    return *label;
+  }
+}
+
+
+const std::string* cas::Surrogate::FindLabel(const uint8_t* bytes) const {
   uint32_t surrogate = 0;
   for (size_t i = 0; i < bytes_per_label_; ++i) {
     int pos = bytes_per_label_ - i - 1;
@@ -60,8 +75,7 @@ std::string cas::Surrogate::MapLabelInv(const std::vector<uint8_t>& bytes) {
   }
   auto it = map_inv_.find(surrogate);
   if (it == map_inv_.end()) {
-    return "";
-  } else {
-    return it->second;
+    return nullptr;
   }
+  return &it->second;
 }
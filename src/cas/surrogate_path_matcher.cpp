@@ -1,4 +1,5 @@
 #include "cas/path_matcher.hpp"
+#include "cas/path_automaton.hpp"
 #include "cas/key_encoding.hpp"
 #include "cas/search_key.hpp"
 #include "cas/utils.hpp"
@@ -11,11 +12,24 @@ cas::SurrogatePathMatcher::SurrogatePathMatcher(cas::Surrogate& surrogate)
 {}
 
 
+void cas::SurrogatePathMatcher::Compile(const cas::BinaryQP& query_path) {
+  automaton_.reset();
+  if (cas::PathAutomaton::Compilable(query_path)) {
+    automaton_.reset(new cas::PathAutomaton(query_path,
+          surrogate_.bytes_per_label_, surrogate_.NrBytes()));
+  }
+}
+
+
 cas::SurrogatePathMatcher::PrefixMatch cas::SurrogatePathMatcher::MatchPathIncremental(
     const std::vector<uint8_t>& path,
     const cas::BinaryQP& qpath,
     size_t len_path,
     State& s) {
+  const cas::PathAutomaton* automaton = Automaton(qpath);
+  if (automaton != nullptr) {
+    return automaton->MatchPathIncremental(path, len_path, s);
+  }
 
   /* cas::Utils::DumpHexValues(path, len_path); */
   /* std::cout << std::endl; */
@@ -67,3 +81,11 @@ cas::SurrogatePathMatcher::PrefixMatch cas::SurrogatePathMatcher::MatchPathIncre
 
   return (s.qpos_ == qpath.Size()) ? MATCH : MISMATCH;
 }
+
+
+bool cas::SurrogatePathMatcher::MatchesAllExtensions(
+    const cas::BinaryQP& /*query_path*/,
+    const State& /*state*/) {
+  // surrogate paths have a fixed length, the leaves decide
+  return false;
+}
@@ -0,0 +1,112 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "query_fixture.hpp"
+#include <deque>
+#include <set>
+#include <string>
+#include <utility>
+
+
+namespace {
+
+const KeyGenerator kFiles("usr", { { "d", 7 }, { "f", 50 } });
+
+template<class VType>
+void RequireSameResults(cas::Cas<VType>& index,
+    std::vector<cas::SearchKey<VType>>& queries) {
+  std::vector<std::set<std::pair<cas::did_t, VType>>> batch(queries.size());
+  index.BatchQuery(queries, [&](size_t query, const cas::Key<VType>& key) {
+    batch[query].insert({ key.did_, key.value_ });
+  });
+  for (size_t i = 0; i < queries.size(); ++i) {
+    std::set<std::pair<cas::did_t, VType>> expected;
+    index.Query(queries[i], [&](const cas::Key<VType>& key) {
+      expected.insert({ key.did_, key.value_ });
+    });
+    REQUIRE(batch[i] == expected);
+  }
+}
+
+} // namespace
+
+
+TEST_CASE("Batch queries match individual queries", "[cas::BatchQuery]") {
+  using VType = cas::vint64_t;
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 2000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 10000));
+  }
+  index.BulkLoad(keys);
+  for (int i = 2000; i < 2100; ++i) {
+    auto key = kFiles.Key<VType>(i, (i * 7919) % 10000);
+    index.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast,
+        cas::InsertTarget::AuxiliaryOnly);
+  }
+  REQUIRE(index.getAuxiliaryIndex() != nullptr);
+
+  std::vector<cas::SearchKey<VType>> queries = {
+    MakeQuery<VType>("/usr^", 5000, cas::VINT64_MAX),
+    MakeQuery<VType>("/usr/d3^", cas::VINT64_MIN, 2500),
+    MakeQuery<VType>("/usr/d3/f10", cas::VINT64_MIN, cas::VINT64_MAX),
+    MakeQuery<VType>("/usr/?/f7", 0, 10000),
+    MakeQuery<VType>("^/f12", 1000, 9000),
+    MakeQuery<VType>("/usr/d1/f1", 0, 0),
+    MakeQuery<VType>("/etc^", cas::VINT64_MIN, cas::VINT64_MAX),
+    MakeQuery<VType>("/usr^", 5000, cas::VINT64_MAX),
+  };
+  RequireSameResults(index, queries);
+
+  std::vector<cas::SearchKey<VType>> empty;
+  cas::QueryStats stats = index.BatchQuery(empty,
+      [](size_t, const cas::Key<VType>&) { FAIL(); });
+  REQUIRE(stats.nr_matches_ == 0);
+}
+
+
+TEST_CASE("Batch queries handle string values", "[cas::BatchQuery]") {
+  using VType = cas::vstring_t;
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 500; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, "v" + std::to_string(i % 37)));
+  }
+  index.BulkLoad(keys);
+
+  std::vector<cas::SearchKey<VType>> queries = {
+    MakeQuery<VType>("^", "", "\xFF"),
+    MakeQuery<VType>("/usr^", "v1", "v2"),
+    MakeQuery<VType>("/usr/d2^", "v", "v3"),
+    MakeQuery<VType>("/usr/?/f4", "v10", "v10"),
+  };
+  RequireSameResults(index, queries);
+}
+
+
+TEST_CASE("Batch queries share the traversal of common prefixes", "[cas::BatchQuery]") {
+  using VType = cas::vint64_t;
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 2000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 10000));
+  }
+  index.BulkLoad(keys);
+
+  std::vector<cas::SearchKey<VType>> queries;
+  for (int d = 0; d < 7; ++d) {
+    queries.push_back(MakeQuery<VType>("/usr/d" + std::to_string(d) + "^",
+          0, 5000));
+  }
+  uint64_t individual_nodes = 0;
+  uint64_t individual_matches = 0;
+  for (auto& skey : queries) {
+    cas::QueryStats stats = index.QueryRuntime(skey);
+    individual_nodes += stats.read_path_nodes_ + stats.read_value_nodes_;
+    individual_matches += stats.nr_matches_;
+  }
+  cas::QueryStats batch = index.BatchQuery(queries,
+      [](size_t, const std::vector<uint8_t>&, const std::vector<uint8_t>&,
+        cas::did_t) {});
+  REQUIRE(batch.nr_matches_ == individual_matches);
+  REQUIRE(batch.read_path_nodes_ + batch.read_value_nodes_ < individual_nodes);
+}
@@ -0,0 +1,68 @@
+#include "test/catch.hpp"
+#include "cas/child_bitmap.hpp"
+#include "cas/node0.hpp"
+#include "cas/node_allocator.hpp"
+#include "cas/node48.hpp"
+#include "cas/node256.hpp"
+#include <vector>
+
+
+TEST_CASE("ChildBitmap ranges across word boundaries", "[cas::ChildBitmap]") {
+  cas::ChildBitmap bitmap;
+  for (int byte : { 0x00, 0x3F, 0x40, 0x7F, 0x80, 0xC0, 0xFF }) {
+    bitmap.Set(static_cast<uint8_t>(byte));
+  }
+  bitmap.Clear(0x80);
+  REQUIRE(bitmap.Count() == 6);
+  REQUIRE(bitmap.Test(0x3F));
+  REQUIRE(!bitmap.Test(0x80));
+
+  std::vector<uint8_t> visited;
+  auto collect = [&](uint8_t byte) -> bool {
+    visited.push_back(byte);
+    return true;
+  };
+  REQUIRE(bitmap.ForEachDescending(0x00, 0xFF, collect));
+  REQUIRE(visited == std::vector<uint8_t>({ 0xFF, 0xC0, 0x7F, 0x40, 0x3F, 0x00 }));
+
+  visited.clear();
+  REQUIRE(bitmap.ForEachDescending(0x3F, 0x7E, collect));
+  REQUIRE(visited == std::vector<uint8_t>({ 0x40, 0x3F }));
+
+  visited.clear();
+  REQUIRE(bitmap.ForEachDescending(0xFF, 0xFF, collect));
+  REQUIRE(visited == std::vector<uint8_t>({ 0xFF }));
+
+  REQUIRE(bitmap.ToVector() ==
+      std::vector<uint8_t>({ 0x00, 0x3F, 0x40, 0x7F, 0xC0, 0xFF }));
+}
+
+
+TEST_CASE("ChildBitmap follows Node48 and Node256 updates", "[cas::ChildBitmap]") {
+  cas::NodeAllocator allocator;
+  cas::Node48* node48 = allocator.New<cas::Node48>(cas::NodeType::Path);
+  for (int i = 0; i < 48; ++i) {
+    node48->Put(static_cast<uint8_t>(i * 5), allocator.New<cas::Node0>());
+  }
+  node48->DeleteNode(10);
+  node48->Put(11, allocator.New<cas::Node0>());
+  REQUIRE(node48->present_.Count() == 48);
+  REQUIRE(node48->LocateChild(10) == nullptr);
+  REQUIRE(node48->LocateChild(11) != nullptr);
+
+  cas::Node* node = node48->Grow(allocator);
+  allocator.Delete(node48);
+  cas::Node256* node256 = static_cast<cas::Node256*>(node);
+  node256->Put(0xFF, allocator.New<cas::Node0>());
+  node256->DeleteNode(0);
+  REQUIRE(node256->present_.Count() == 48);
+  std::vector<uint8_t> keys = node256->GetKeys();
+  REQUIRE(keys.size() == 48);
+  REQUIRE(keys.front() == 5);
+  REQUIRE(keys.back() == 0xFF);
+
+  node = node256->Shrink(allocator);
+  allocator.Delete(node256);
+  REQUIRE(node->GetKeys() == keys);
+  REQUIRE(node->LocateChild(0xFF) != nullptr);
+}
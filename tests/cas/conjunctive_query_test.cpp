@@ -0,0 +1,115 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "cas/did_set.hpp"
+#include "query_fixture.hpp"
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+using VType = cas::vint64_t;
+
+void Load(cas::Cas<VType>& index) {
+  // every document lists a battery and a canoe item
+  std::deque<cas::Key<VType>> keys;
+  for (int did = 0; did < 2000; ++did) {
+    cas::Key<VType> battery;
+    battery.path_ = { "bom", "item", "car", "battery" };
+    battery.value_ = (did * 7919) % 500000;
+    battery.did_ = did;
+    keys.push_back(battery);
+    cas::Key<VType> canoe;
+    canoe.path_ = { "bom", "item", "canoe" };
+    canoe.value_ = (did * 104729) % 100000;
+    canoe.did_ = did;
+    keys.push_back(canoe);
+  }
+  index.BulkLoad(keys);
+}
+
+} // namespace
+
+
+TEST_CASE("DidSet probes sparse and dense sets", "[cas::DidSet]") {
+  cas::DidSet sparse({ 900000, 5, 17, 5, 300 });
+  REQUIRE(!sparse.IsBitmap());
+  REQUIRE(sparse.Dids() == std::vector<cas::did_t>({ 5, 17, 300, 900000 }));
+  REQUIRE(sparse.Contains(17));
+  REQUIRE(!sparse.Contains(18));
+  REQUIRE(!sparse.Contains(0));
+
+  std::vector<cas::did_t> even;
+  for (cas::did_t did = 100; did < 1100; did += 2) {
+    even.push_back(did);
+  }
+  std::vector<cas::did_t> expected = even;
+  cas::DidSet dense(std::move(even));
+  REQUIRE(dense.IsBitmap());
+  REQUIRE(dense.Size() == 500);
+  REQUIRE(dense.Dids() == expected);
+  REQUIRE(dense.Contains(100));
+  REQUIRE(dense.Contains(1098));
+  REQUIRE(!dense.Contains(101));
+  REQUIRE(!dense.Contains(1100));
+  REQUIRE(!dense.Contains(98));
+
+  REQUIRE(cas::DidSet().Empty());
+}
+
+
+TEST_CASE("Conjunctive queries intersect the DIDs of their predicates", "[cas::ConjunctiveQuery]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  Load(index);
+
+  std::vector<cas::SearchKey<VType>> keys = {
+    MakeQuery<VType>("/bom/item/car/battery", 250001, cas::VINT64_MAX),
+    MakeQuery<VType>("/bom/item/canoe", cas::VINT64_MIN, 69999),
+    MakeQuery<VType>("/bom^", 0, 20000),
+  };
+  std::set<cas::did_t> expected = Dids(index, keys[0]);
+  for (size_t i = 1; i < keys.size(); ++i) {
+    std::set<cas::did_t> dids = Dids(index, keys[i]);
+    std::set<cas::did_t> intersection;
+    std::set_intersection(expected.begin(), expected.end(),
+        dids.begin(), dids.end(),
+        std::inserter(intersection, intersection.begin()));
+    expected = intersection;
+  }
+  REQUIRE(!expected.empty());
+
+  std::vector<cas::did_t> dids;
+  cas::ConjunctiveQueryStats stats = index.ConjunctiveQuery(keys,
+      [&](cas::did_t did) { dids.push_back(did); });
+  REQUIRE(dids == std::vector<cas::did_t>(expected.begin(), expected.end()));
+  REQUIRE(stats.nr_matches_ == static_cast<int32_t>(expected.size()));
+  REQUIRE(stats.predicates_.size() == keys.size());
+  REQUIRE(stats.order_.size() == keys.size());
+  REQUIRE(stats.nr_candidates_.back() == expected.size());
+  // the most selective predicate is executed first
+  REQUIRE(stats.order_[0] == 2);
+  REQUIRE(stats.predicates_[2].nr_matches_ ==
+      index.QueryRuntime(keys[2]).nr_matches_);
+}
+
+
+TEST_CASE("Conjunctive queries skip predicates once no candidate is left", "[cas::ConjunctiveQuery]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  Load(index);
+
+  std::vector<cas::SearchKey<VType>> keys = {
+    MakeQuery<VType>("/bom/item/car/battery", 0, 500000),
+    MakeQuery<VType>("/bom/item/boat", 0, 500000),
+    MakeQuery<VType>("/bom/item/canoe", 0, 100000),
+  };
+  size_t nr_dids = 0;
+  cas::ConjunctiveQueryStats stats = index.ConjunctiveQuery(keys,
+      [&](cas::did_t) { ++nr_dids; });
+  REQUIRE(nr_dids == 0);
+  REQUIRE(stats.order_ == std::vector<size_t>({ 1 }));
+  REQUIRE(stats.predicates_[0].read_path_nodes_ == 0);
+  REQUIRE(stats.predicates_[2].read_path_nodes_ == 0);
+}
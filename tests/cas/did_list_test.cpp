@@ -0,0 +1,81 @@
+#include "test/catch.hpp"
+#include "cas/did_list.hpp"
+#include "comparator.hpp"
+#include <algorithm>
+
+
+TEST_CASE("DidList keeps DIDs sorted", "[cas::DidList]") {
+  std::vector<cas::did_t> input = { 900, 3, 70000, 3, 128, 1ull << 40, 0 };
+  std::vector<cas::did_t> expected = input;
+  std::sort(expected.begin(), expected.end());
+
+  cas::DidList dids;
+  for (cas::did_t did : input) {
+    dids.push_back(did);
+  }
+  REQUIRE(!dids.IsInline());
+  REQUIRE(dids.size() == expected.size());
+  REQUIRE(Comparator::Equals(dids.ToVector(), expected));
+  REQUIRE(dids.Contains(70000));
+  REQUIRE(!dids.Contains(71));
+}
+
+
+TEST_CASE("DidList erase", "[cas::DidList]") {
+  cas::DidList dids;
+  for (cas::did_t did = 1; did <= 5000; ++did) {
+    dids.push_back(did * 7);
+  }
+  REQUIRE(dids.size() == 5000);
+  REQUIRE(dids.HeapBytes() < 5000 * sizeof(cas::did_t));
+
+  REQUIRE(dids.Erase(7 * 2500) == 1);
+  REQUIRE(dids.Erase(3) == 0);
+  REQUIRE(dids.size() == 4999);
+  REQUIRE(!dids.Contains(7 * 2500));
+  REQUIRE(dids.Contains(7 * 2501));
+
+  cas::DidList small;
+  small.push_back(1);
+  small.push_back(2);
+  small.push_back(2);
+  REQUIRE(small.Erase(2) == 2);
+  REQUIRE(small.IsInline());
+  REQUIRE(small.size() == 1);
+  REQUIRE(*small.begin() == 1);
+}
+
+
+TEST_CASE("DidList inserts and erases in place", "[cas::DidList]") {
+  std::vector<cas::did_t> expected;
+  cas::DidList dids;
+  uint64_t seed = 42;
+  for (int i = 0; i < 5000; ++i) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    // a few large gaps make some deltas longer than one byte
+    cas::did_t did = (seed >> 33) % 3000 + ((seed >> 20) % 7 == 0 ? 1ull << 35 : 0);
+    if ((seed >> 40) % 3 == 0) {
+      size_t nr_erased = std::count(expected.begin(), expected.end(), did);
+      expected.erase(std::remove(expected.begin(), expected.end(), did),
+          expected.end());
+      REQUIRE(dids.Erase(did) == nr_erased);
+    } else {
+      expected.insert(std::upper_bound(expected.begin(), expected.end(), did), did);
+      dids.push_back(did);
+    }
+    REQUIRE(dids.size() == expected.size());
+  }
+  REQUIRE(Comparator::Equals(dids.ToVector(), expected));
+
+  // erasing the largest DID keeps appending in order
+  cas::did_t last = expected.back();
+  dids.Erase(last);
+  dids.push_back(last);
+  REQUIRE(Comparator::Equals(dids.ToVector(), expected));
+
+  for (cas::did_t did : std::vector<cas::did_t>(expected)) {
+    dids.Erase(did);
+  }
+  REQUIRE(dids.empty());
+  REQUIRE(dids.IsInline());
+}
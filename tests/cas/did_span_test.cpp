@@ -0,0 +1,92 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "cas/cas_seq.hpp"
+#include "query_fixture.hpp"
+#include <deque>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+namespace {
+
+using VType = cas::vint64_t;
+using BinaryMatch = std::tuple<std::vector<uint8_t>, std::vector<uint8_t>, cas::did_t>;
+
+// few distinct keys, so that most leaves store many DIDs
+const KeyGenerator kFiles("usr", { { "d", 5 }, { "f", 3 } });
+
+template<class Index>
+std::multiset<BinaryMatch> PerDid(Index& index, cas::SearchKey<VType>& skey) {
+  std::multiset<BinaryMatch> matches;
+  index.Query(skey, [&](const std::vector<uint8_t>& buffer_path,
+        const std::vector<uint8_t>& buffer_value, cas::did_t did) {
+    matches.insert(BinaryMatch(buffer_path, buffer_value, did));
+  });
+  return matches;
+}
+
+template<class Index>
+std::multiset<BinaryMatch> PerSpan(Index& index, cas::SearchKey<VType>& skey,
+    size_t& nr_calls) {
+  std::multiset<BinaryMatch> matches;
+  nr_calls = 0;
+  index.Query(skey, [&](const std::vector<uint8_t>& buffer_path,
+        const std::vector<uint8_t>& buffer_value, const cas::DidSpan& dids) {
+    ++nr_calls;
+    for (cas::did_t did : dids) {
+      matches.insert(BinaryMatch(buffer_path, buffer_value, did));
+    }
+  });
+  return matches;
+}
+
+} // namespace
+
+
+TEST_CASE("DID spans deliver the DIDs of a leaf in one call", "[cas::DidSpan]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  cas::CasSeq<VType> seq({});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 3000; ++i) {
+    auto key = kFiles.Key<VType>(i, i % 4);
+    keys.push_back(key);
+    seq.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast);
+  }
+  index.BulkLoad(keys);
+  for (int i = 3000; i < 3200; ++i) {
+    auto key = kFiles.Key<VType>(i, i % 4);
+    index.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast,
+        cas::InsertTarget::AuxiliaryOnly);
+    seq.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast);
+  }
+
+  std::vector<cas::SearchKey<VType>> queries = {
+    MakeQuery<VType>("/usr^", cas::VINT64_MIN, cas::VINT64_MAX),
+    MakeQuery<VType>("/usr/d3^", 1, 2),
+    MakeQuery<VType>("/usr/?/f1", 0, 3),
+    MakeQuery<VType>("/etc^", cas::VINT64_MIN, cas::VINT64_MAX),
+  };
+  for (auto& skey : queries) {
+    std::multiset<BinaryMatch> expected = PerDid(index, skey);
+    cas::QueryStats stats = index.QueryRuntime(skey);
+    size_t nr_calls;
+    REQUIRE(PerSpan(index, skey, nr_calls) == expected);
+    REQUIRE(stats.nr_matches_ == static_cast<int32_t>(expected.size()));
+    if (!expected.empty()) {
+      // one call per matching leaf in the main and the auxiliary index
+      REQUIRE(nr_calls < expected.size());
+    }
+
+    index.concurrent_auxiliary_query_ = true;
+    REQUIRE(PerSpan(index, skey, nr_calls) == expected);
+    index.concurrent_auxiliary_query_ = false;
+
+    // the sequential scan emits one key per call
+    std::multiset<BinaryMatch> scanned = PerDid(seq, skey);
+    REQUIRE(scanned.size() == expected.size());
+    REQUIRE(PerSpan(seq, skey, nr_calls) == scanned);
+    REQUIRE(nr_calls == scanned.size());
+  }
+}
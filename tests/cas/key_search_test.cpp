@@ -0,0 +1,31 @@
+#include "test/catch.hpp"
+#include "cas/key_search.hpp"
+#include <vector>
+
+
+TEST_CASE("KeySearch Find ignores keys past nr_keys", "[cas::KeySearch]") {
+  uint8_t keys[16] = { 0x00, 0x10, 0x7F, 0x80, 0xFF, 0x42 };
+  REQUIRE(cas::KeySearch::Find<16>(keys, 5, 0x00) == 0);
+  REQUIRE(cas::KeySearch::Find<16>(keys, 5, 0x80) == 3);
+  REQUIRE(cas::KeySearch::Find<16>(keys, 5, 0xFF) == 4);
+  REQUIRE(cas::KeySearch::Find<16>(keys, 5, 0x42) == -1);
+  REQUIRE(cas::KeySearch::Find<16>(keys, 0, 0x00) == -1);
+  REQUIRE(cas::KeySearch::Find<4>(keys, 4, 0x80) == 3);
+  REQUIRE(cas::KeySearch::Find<4>(keys, 3, 0x80) == -1);
+}
+
+
+TEST_CASE("KeySearch RangeMask compares unsigned bytes", "[cas::KeySearch]") {
+  uint8_t keys[16];
+  for (int i = 0; i < 16; ++i) {
+    keys[i] = static_cast<uint8_t>(i * 17); // 0x00, 0x11, ..., 0xFF
+  }
+  REQUIRE(cas::KeySearch::RangeMask<16>(keys, 16, 0x00, 0xFF) == 0xFFFF);
+  REQUIRE(cas::KeySearch::RangeMask<16>(keys, 16, 0x80, 0xFF) == 0xFF00);
+  REQUIRE(cas::KeySearch::RangeMask<16>(keys, 16, 0x11, 0x33) == 0x000E);
+  REQUIRE(cas::KeySearch::RangeMask<16>(keys, 10, 0x80, 0xFF) == 0x0300);
+  REQUIRE(cas::KeySearch::RangeMask<16>(keys, 16, 0x12, 0x21) == 0);
+  REQUIRE(cas::KeySearch::RangeMask<4>(keys, 4, 0x10, 0xFF) == 0xE);
+  REQUIRE(cas::KeySearch::HighestBit(0xFF00) == 15);
+  REQUIRE(cas::KeySearch::HighestBit(0x1) == 0);
+}
@@ -0,0 +1,81 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "cas/match_view.hpp"
+#include "query_fixture.hpp"
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+const KeyGenerator kFiles("usr", { { "d", 7 }, { "f", 31 } });
+
+template<class VType>
+void RequireViewsMatchKeys(cas::Cas<VType>& index, cas::SearchKey<VType>& skey) {
+  std::vector<cas::Key<VType>> expected;
+  index.Query(skey, [&](const cas::Key<VType>& key) {
+    expected.push_back(key);
+  });
+  std::vector<cas::Key<VType>> keys;
+  index.Query(skey, [&](const cas::MatchView<VType>& match) {
+    cas::Key<VType> key = match.ToKey();
+    REQUIRE(match.Did() == key.did_);
+    REQUIRE(match.Value() == key.value_);
+    REQUIRE(match.NrLabels() == key.path_.size());
+    for (size_t i = 0; i < key.path_.size(); ++i) {
+      REQUIRE(match.Label(i) == cas::StringView(key.path_[i]));
+    }
+    REQUIRE(match.Label(key.path_.size()).empty());
+    REQUIRE(match.LastLabel() == cas::StringView(key.path_.back()));
+    keys.push_back(key);
+  });
+  REQUIRE(!expected.empty());
+  REQUIRE(keys == expected);
+}
+
+} // namespace
+
+
+TEST_CASE("Match views decode like KeyDecoder", "[cas::MatchView]") {
+  using VType = cas::vint64_t;
+  std::unique_ptr<cas::Cas<VType>> indexes[] = {
+    std::unique_ptr<cas::Cas<VType>>(
+        new cas::Cas<VType>(cas::IndexType::TwoDimensional, {})),
+    std::unique_ptr<cas::Cas<VType>>(
+        new cas::Cas<VType>(cas::IndexType::TwoDimensional, {}, 5, 2)),
+  };
+  for (auto& index : indexes) {
+    std::deque<cas::Key<VType>> keys;
+    for (int i = 0; i < 1000; ++i) {
+      keys.push_back(kFiles.Key<VType>(i, i - 500));
+    }
+    index->BulkLoad(keys);
+    cas::SearchKey<VType> skey;
+    skey.path_ = { "/usr/d3^" };
+    skey.low_  = -100;
+    skey.high_ = cas::VINT64_MAX;
+    RequireViewsMatchKeys(*index, skey);
+  }
+}
+
+
+TEST_CASE("Match views expose string values without a copy", "[cas::MatchView]") {
+  using VType = cas::vstring_t;
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 1000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, "value" + std::to_string(i % 50)));
+  }
+  index.BulkLoad(keys);
+  cas::SearchKey<VType> skey;
+  skey.path_ = { "/usr/?/f1" };
+  skey.low_  = "value1";
+  skey.high_ = "value3";
+  RequireViewsMatchKeys(index, skey);
+
+  index.Query(skey, [&](const cas::MatchView<VType>& match) {
+    REQUIRE(match.StringValue() == cas::StringView(match.Value()));
+  });
+}
@@ -24,5 +24,5 @@ TEST_CASE("Node0 Constructor", "[cas::Node0]") {
       node.dids_.end());
   REQUIRE(node.separator_pos_ == 4);
   REQUIRE(node.Type() == cas::NodeType::Leaf);
-  REQUIRE(Comparator::Equals(node.prefix_, expected_prefix_));
+  REQUIRE(Comparator::Equals(node.prefix_.ToVector(), expected_prefix_));
 }
@@ -0,0 +1,108 @@
+#include "test/catch.hpp"
+#include "cas/node_allocator.hpp"
+#include "cas/node0.hpp"
+#include "cas/node4.hpp"
+#include "cas/node16.hpp"
+#include "cas/node48.hpp"
+
+
+TEST_CASE("NodeAllocator reuses freed nodes", "[cas::NodeAllocator]") {
+  cas::NodeAllocator allocator;
+
+  cas::Node0* leaf = allocator.New<cas::Node0>();
+  leaf->dids_.push_back(42);
+  allocator.Delete(leaf);
+
+  cas::Node0* other = allocator.New<cas::Node0>();
+  REQUIRE(other == leaf);
+  REQUIRE(other->dids_.empty());
+
+  cas::IndexStats stats;
+  allocator.CollectStats(stats);
+  REQUIRE(stats.alloc_slabs_ == 1);
+  REQUIRE(stats.alloc_live_nodes_ == 1);
+  REQUIRE(stats.alloc_free_nodes_ == 0);
+}
+
+
+TEST_CASE("NodeAllocator Grow uses free list", "[cas::NodeAllocator]") {
+  cas::NodeAllocator allocator;
+
+  cas::Node4* node4 = allocator.New<cas::Node4>(cas::NodeType::Path);
+  for (uint8_t byte = 0; byte < 4; ++byte) {
+    node4->Put(byte, allocator.New<cas::Node0>());
+  }
+  cas::Node* node8 = node4->Grow(allocator);
+  allocator.Delete(node4);
+  REQUIRE(node8->NodeWidth() == 8);
+  REQUIRE(node8->nr_children_ == 4);
+
+  cas::IndexStats stats;
+  allocator.CollectStats(stats);
+  REQUIRE(stats.alloc_live_nodes_ == 5);
+  REQUIRE(stats.alloc_free_nodes_ == 1);
+
+  allocator.Release();
+  stats = cas::IndexStats{};
+  allocator.CollectStats(stats);
+  REQUIRE(stats.alloc_slabs_ == 0);
+  REQUIRE(stats.alloc_live_nodes_ == 0);
+}
+
+
+#ifdef CAS_COMPACT_REFS
+TEST_CASE("NodeAllocator references round trip", "[cas::NodeAllocator]") {
+  cas::NodeAllocator first;
+  cas::NodeAllocator second;
+  std::vector<cas::Node*> nodes;
+  for (int i = 0; i < 2000; ++i) {
+    nodes.push_back(first.New<cas::Node0>());
+    nodes.push_back(second.New<cas::Node16>(cas::NodeType::Value));
+  }
+  REQUIRE(cas::NodeAllocator::Encode(nullptr) == 0);
+  REQUIRE(cas::NodeAllocator::Decode(0) == nullptr);
+  size_t nr_mismatches = 0;
+  for (cas::Node* node : nodes) {
+    uint32_t ref = cas::NodeAllocator::Encode(node);
+    if (ref == 0 || cas::NodeAllocator::Decode(ref) != node) {
+      ++nr_mismatches;
+    }
+  }
+  REQUIRE(nr_mismatches == 0);
+
+  cas::ChildRef child = nodes.back();
+  REQUIRE(child != nullptr);
+  REQUIRE(child->NodeWidth() == 16);
+  child = nullptr;
+  REQUIRE(child == nullptr);
+}
+#endif
+
+
+TEST_CASE("NodeAllocator aligns inner nodes", "[cas::NodeAllocator]") {
+  const uintptr_t align = cas::NodeAllocator::kInnerNodeAlign;
+  cas::NodeAllocator allocator;
+  size_t nr_unaligned = 0;
+  for (int i = 0; i < 100; ++i) {
+    allocator.New<cas::Node0>();
+    uintptr_t address4 = reinterpret_cast<uintptr_t>(
+        allocator.New<cas::Node4>(cas::NodeType::Path));
+    uintptr_t address48 = reinterpret_cast<uintptr_t>(
+        allocator.New<cas::Node48>(cas::NodeType::Path));
+    nr_unaligned += (address4 % align != 0) + (address48 % align != 0);
+  }
+  REQUIRE(nr_unaligned == 0);
+
+  // the keys directly follow the header
+  cas::Node16* node16 = allocator.New<cas::Node16>(cas::NodeType::Path);
+  REQUIRE(reinterpret_cast<uintptr_t>(node16->keys_ + 16) -
+      reinterpret_cast<uintptr_t>(node16) <= 64);
+
+  // the node sizes include the padding to the block boundary
+  REQUIRE(node16->SizeBytes() % align == 0);
+  cas::IndexStats stats;
+  allocator.CollectStats(stats);
+  REQUIRE(stats.alloc_live_bytes_ - stats.alloc_padding_bytes_ ==
+      100 * (sizeof(cas::Node0) + sizeof(cas::Node4) + sizeof(cas::Node48)) +
+      sizeof(cas::Node16));
+}
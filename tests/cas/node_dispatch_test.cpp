@@ -0,0 +1,32 @@
+#include "test/catch.hpp"
+#include "cas/node_allocator.hpp"
+#include "cas/node_dispatch.hpp"
+
+
+TEST_CASE("NodeDispatch ForEachChild stops early", "[cas::NodeDispatch]") {
+  cas::NodeAllocator allocator;
+  cas::Node* node = allocator.New<cas::Node48>(cas::NodeType::Path);
+  for (uint8_t byte = 1; byte <= 4; ++byte) {
+    node->Put(byte, allocator.New<cas::Node0>());
+  }
+
+  std::vector<uint8_t> visited;
+  bool completed = cas::NodeDispatch::ForEachChild(node, 0x00, 0x03,
+      [&](uint8_t byte, cas::Node&) -> bool {
+    visited.push_back(byte);
+    return byte != 2;
+  });
+  REQUIRE(!completed);
+  REQUIRE(visited == std::vector<uint8_t>({ 3, 2 }));
+
+  visited.clear();
+  completed = node->ForEachChild([&](uint8_t byte, cas::Node&) -> bool {
+    visited.push_back(byte);
+    return true;
+  });
+  REQUIRE(completed);
+  REQUIRE(visited == std::vector<uint8_t>({ 4, 3, 2, 1 }));
+
+  REQUIRE(cas::NodeDispatch::LocateChild(node, 4) != nullptr);
+  REQUIRE(cas::NodeDispatch::LocateChild(node, 5) == nullptr);
+}
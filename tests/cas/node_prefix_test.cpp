@@ -0,0 +1,33 @@
+#include "test/catch.hpp"
+#include "cas/node_prefix.hpp"
+#include "comparator.hpp"
+
+
+TEST_CASE("NodePrefix spills long prefixes", "[cas::NodePrefix]") {
+  std::vector<uint8_t> expected;
+  cas::NodePrefix prefix;
+  for (int i = 0; i < 100; ++i) {
+    prefix.push_back(static_cast<uint8_t>(i));
+    expected.push_back(static_cast<uint8_t>(i));
+    REQUIRE(prefix.IsInline() == (prefix.size() <= cas::NodePrefix::kInlineBytes));
+  }
+  REQUIRE(Comparator::Equals(prefix.ToVector(), expected));
+
+  cas::NodePrefix moved = std::move(prefix);
+  REQUIRE(prefix.empty());
+  REQUIRE(Comparator::Equals(moved.ToVector(), expected));
+}
+
+
+TEST_CASE("NodePrefix insert and erase", "[cas::NodePrefix]") {
+  std::vector<uint8_t> bytes = { 0x01, 0x02, 0x03 };
+  cas::NodePrefix prefix;
+  prefix = bytes;
+  prefix.insert(prefix.begin() + 1, bytes.begin(), bytes.end());
+  prefix.erase(prefix.begin());
+
+  std::vector<uint8_t> expected = { 0x01, 0x02, 0x03, 0x02, 0x03 };
+  REQUIRE(prefix.size() == expected.size());
+  REQUIRE(Comparator::Equals(prefix.ToVector(), expected));
+  REQUIRE(prefix.HeapBytes() == 0);
+}
@@ -0,0 +1,60 @@
+#include "test/catch.hpp"
+#include "cas/node_allocator.hpp"
+#include "cas/node_dispatch.hpp"
+#include <vector>
+
+
+namespace {
+
+std::vector<uint8_t> VisitedKeys(cas::Node* node, uint8_t low, uint8_t high) {
+  std::vector<uint8_t> keys;
+  cas::NodeDispatch::ForEachChild(node, low, high,
+      [&](uint8_t byte, cas::Node&) -> bool {
+    keys.push_back(byte);
+    return true;
+  });
+  return keys;
+}
+
+} // namespace
+
+
+TEST_CASE("Nodes grow and shrink through all widths", "[cas::Node]") {
+  cas::NodeAllocator allocator;
+  cas::Node* node = allocator.New<cas::Node4>(cas::NodeType::Value);
+  std::vector<int> widths = { 4 };
+
+  // insert keys in descending order so that Put has to shift the keys
+  for (int byte = 255; byte >= 0; byte -= 3) {
+    if (node->IsFull()) {
+      cas::Node* grown = node->Grow(allocator);
+      allocator.Delete(node);
+      node = grown;
+      widths.push_back(node->NodeWidth());
+    }
+    node->Put(static_cast<uint8_t>(byte), allocator.New<cas::Node0>());
+  }
+  REQUIRE(widths == std::vector<int>({ 4, 8, 16, 32, 48, 256 }));
+  REQUIRE(node->nr_children_ == 86);
+  REQUIRE(cas::NodeDispatch::LocateChild(node, 0) != nullptr);
+  REQUIRE(cas::NodeDispatch::LocateChild(node, 1) == nullptr);
+
+  widths = { node->NodeWidth() };
+  for (int byte = 255; node->nr_children_ > 1; byte -= 3) {
+    allocator.Delete(cas::NodeDispatch::LocateChild(node, byte));
+    node->DeleteNode(static_cast<uint8_t>(byte));
+    if (node->IsUnderfilled() && node->NodeWidth() > 4) {
+      cas::Node* shrunk = node->Shrink(allocator);
+      allocator.Delete(node);
+      node = shrunk;
+      widths.push_back(node->NodeWidth());
+      // keys 0, 3, ..., byte-3 are left
+      std::vector<uint8_t> keys = VisitedKeys(node, 0x00, 0xFF);
+      REQUIRE(keys.size() == node->nr_children_);
+      REQUIRE(keys.front() == byte - 3);
+      REQUIRE(keys.back() == 0);
+      REQUIRE(VisitedKeys(node, 1, 5) == std::vector<uint8_t>({ 3 }));
+    }
+  }
+  REQUIRE(widths == std::vector<int>({ 256, 48, 32, 16, 8, 4 }));
+}
@@ -0,0 +1,96 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "query_fixture.hpp"
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+using VType = cas::vint64_t;
+
+const KeyGenerator kFiles("var", { { "d", 11 }, { "f", 97 } });
+
+std::vector<VType> Values(cas::Cas<VType>& index, cas::SearchKey<VType>& skey,
+    cas::ValueOrder order, size_t limit) {
+  std::vector<VType> values;
+  index.OrderedQuery(skey, [&](const cas::Key<VType>& key) {
+    values.push_back(key.value_);
+  }, order, limit);
+  return values;
+}
+
+} // namespace
+
+
+TEST_CASE("Ordered queries return the matches sorted by value", "[cas::OrderedQuery]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 3000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 5000 - 2500));
+  }
+  index.BulkLoad(keys);
+  for (int i = 3000; i < 3500; ++i) {
+    auto key = kFiles.Key<VType>(i, (i * 7919) % 5000 - 2500);
+    index.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast,
+        cas::InsertTarget::AuxiliaryOnly);
+  }
+  REQUIRE(index.getAuxiliaryIndex() != nullptr);
+
+  std::vector<cas::SearchKey<VType>> queries = {
+    MakeQuery<VType>("/var^", cas::VINT64_MIN, cas::VINT64_MAX),
+    MakeQuery<VType>("/var/d3^", -1000, 1000),
+    MakeQuery<VType>("^/f12", cas::VINT64_MIN, 0),
+    MakeQuery<VType>("/etc^", cas::VINT64_MIN, cas::VINT64_MAX),
+  };
+  for (auto& skey : queries) {
+    std::vector<VType> expected;
+    index.Query(skey, [&](const cas::Key<VType>& key) {
+      expected.push_back(key.value_);
+    });
+    std::sort(expected.begin(), expected.end());
+
+    SECTION("ascending") {
+      REQUIRE(Values(index, skey, cas::ValueOrder::Ascending,
+            std::numeric_limits<size_t>::max()) == expected);
+    }
+
+    SECTION("descending") {
+      std::reverse(expected.begin(), expected.end());
+      REQUIRE(Values(index, skey, cas::ValueOrder::Descending,
+            std::numeric_limits<size_t>::max()) == expected);
+    }
+
+    SECTION("top-k") {
+      std::reverse(expected.begin(), expected.end());
+      for (size_t k : { 0, 1, 10, 100 }) {
+        std::vector<VType> top(expected.begin(),
+            expected.begin() + std::min(k, expected.size()));
+        REQUIRE(Values(index, skey, cas::ValueOrder::Descending, k) == top);
+      }
+    }
+  }
+}
+
+
+TEST_CASE("Top-k queries only expand the subtrees they need", "[cas::OrderedQuery]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 3000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 5000 - 2500));
+  }
+  index.BulkLoad(keys);
+
+  auto skey = MakeQuery<VType>("/var^", cas::VINT64_MIN, cas::VINT64_MAX);
+  size_t nr_matches = 0;
+  cas::QueryStats stats = index.OrderedQuery(skey,
+      [&](const cas::Key<VType>&) { ++nr_matches; },
+      cas::ValueOrder::Descending, 5);
+  cas::QueryStats full = index.QueryRuntime(skey);
+  REQUIRE(nr_matches == 5);
+  REQUIRE(stats.nr_matches_ == 5);
+  REQUIRE(stats.read_path_nodes_ + stats.read_value_nodes_ <
+      full.read_path_nodes_ + full.read_value_nodes_);
+}
@@ -0,0 +1,135 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "query_fixture.hpp"
+#include <deque>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+namespace {
+
+using VType = cas::vint64_t;
+
+const KeyGenerator kFiles("usr",
+    { { "d", 13 }, { "s", 7 }, { "f", 101 } });
+
+} // namespace
+
+
+TEST_CASE("Parallel queries match sequential queries", "[cas::ParallelQuery]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 5000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 10000));
+  }
+  index.BulkLoad(keys);
+  for (int i = 5000; i < 5300; ++i) {
+    auto key = kFiles.Key<VType>(i, (i * 7919) % 10000);
+    index.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast,
+        cas::InsertTarget::AuxiliaryOnly);
+  }
+  REQUIRE(index.getAuxiliaryIndex() != nullptr);
+
+  std::vector<cas::SearchKey<VType>> queries = {
+    MakeQuery<VType>("/usr^", cas::VINT64_MIN, cas::VINT64_MAX),
+    MakeQuery<VType>("/usr^", 2000, 4000),
+    MakeQuery<VType>("/usr/d3^", cas::VINT64_MIN, 2500),
+    MakeQuery<VType>("/usr/?/s2/f7", 0, 10000),
+    MakeQuery<VType>("^/f12", 1000, 9000),
+    MakeQuery<VType>("/usr/d1/s1/f1", 0, 0),
+    MakeQuery<VType>("/etc^", cas::VINT64_MIN, cas::VINT64_MAX),
+  };
+  for (auto& skey : queries) {
+    std::multiset<Match<VType>> expected = Matches(index, skey);
+    cas::QueryStats sequential = index.QueryRuntime(skey);
+    for (size_t nr_threads : { 1, 2, 4, 7 }) {
+      std::multiset<Match<VType>> matches;
+      cas::QueryStats stats = index.ParallelQuery(skey,
+          [&](const cas::Key<VType>& key) {
+        matches.insert(Match<VType>(key.path_, key.value_, key.did_));
+      }, nr_threads);
+      REQUIRE(matches == expected);
+      REQUIRE(stats.nr_matches_ == static_cast<int32_t>(expected.size()));
+      // every node is visited exactly once by one of the workers
+      REQUIRE(stats.read_path_nodes_ == sequential.read_path_nodes_);
+      REQUIRE(stats.read_value_nodes_ == sequential.read_value_nodes_);
+    }
+  }
+}
+
+
+TEST_CASE("Main and auxiliary index can be searched concurrently", "[cas::Query]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 3000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 10000));
+  }
+  index.BulkLoad(keys);
+  for (int i = 3000; i < 4000; ++i) {
+    auto key = kFiles.Key<VType>(i, (i * 7919) % 10000);
+    index.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast,
+        cas::InsertTarget::AuxiliaryOnly);
+  }
+  REQUIRE(index.getAuxiliaryIndex() != nullptr);
+
+  std::vector<cas::SearchKey<VType>> queries = {
+    MakeQuery<VType>("/usr^", cas::VINT64_MIN, cas::VINT64_MAX),
+    MakeQuery<VType>("/usr/d3^", cas::VINT64_MIN, 2500),
+    MakeQuery<VType>("^/f12", 1000, 9000),
+    MakeQuery<VType>("/etc^", cas::VINT64_MIN, cas::VINT64_MAX),
+  };
+  for (auto& skey : queries) {
+    std::multiset<Match<VType>> expected = Matches(index, skey);
+    cas::QueryStats sequential = index.QueryRuntime(skey);
+    index.concurrent_auxiliary_query_ = true;
+    std::multiset<Match<VType>> matches = Matches(index, skey);
+    cas::QueryStats concurrent = index.QueryRuntime(skey);
+    index.concurrent_auxiliary_query_ = false;
+    REQUIRE(matches == expected);
+    REQUIRE(concurrent.nr_matches_ == sequential.nr_matches_);
+    REQUIRE(concurrent.read_path_nodes_ == sequential.read_path_nodes_);
+    REQUIRE(concurrent.read_value_nodes_ == sequential.read_value_nodes_);
+  }
+
+  // the auxiliary search reuses the auxiliary context of the caller
+  index.concurrent_auxiliary_query_ = true;
+  cas::QueryContext context;
+  size_t nr_matches = 0;
+  auto count = [&](const std::vector<uint8_t>&, const std::vector<uint8_t>&,
+      cas::did_t) { ++nr_matches; };
+  index.Query(queries[0], count, context);
+  cas::QueryContext* auxiliary = &context.Auxiliary();
+  index.Query(queries[0], count, context);
+  REQUIRE(&context.Auxiliary() == auxiliary);
+  REQUIRE(nr_matches == 8000);
+}
+
+
+TEST_CASE("Exceptions of emitters leave concurrent searches cleanly", "[cas::Query]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 3000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 10000));
+  }
+  index.BulkLoad(keys);
+  for (int i = 3000; i < 4000; ++i) {
+    auto key = kFiles.Key<VType>(i, (i * 7919) % 10000);
+    index.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast,
+        cas::InsertTarget::AuxiliaryOnly);
+  }
+  index.concurrent_auxiliary_query_ = true;
+
+  auto skey = MakeQuery<VType>("/usr^", cas::VINT64_MIN, cas::VINT64_MAX);
+  size_t nr_calls = 0;
+  REQUIRE_THROWS_AS(index.Query(skey, [&](cas::did_t) {
+    if (++nr_calls == 10) {
+      throw std::runtime_error{"stop"};
+    }
+  }), std::runtime_error);
+  REQUIRE(nr_calls == 10);
+  // the index stays usable after the auxiliary thread was joined
+  REQUIRE(Matches(index, skey).size() == 4000);
+}
@@ -3,8 +3,10 @@
 #include "cas/path_matcher.hpp"
 #include "cas/utils.hpp"
 #include "comparator.hpp"
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <vector>
 
 
 TEST_CASE("Matching a complete path", "[cas::PathMatcher]") {
@@ -131,3 +133,123 @@ TEST_CASE("Matching a complete path", "[cas::PathMatcher]") {
   /*   REQUIRE(match("/", "^?") == false); */
   /* } */
 }
+
+
+namespace {
+
+cas::Key<cas::vint64_t> ParsePath(const std::string& input) {
+  cas::Key<cas::vint64_t> key;
+  for (size_t i = 1; i < input.size(); ++i) {
+    size_t j = 0;
+    while (i+j < input.size() && input[i+j] != '/') {
+      ++j;
+    }
+    key.path_.push_back(input.substr(i, j));
+    i += j;
+  }
+  return key;
+}
+
+/**
+ * Feeds path to an interpreting and a compiled matcher in chunks of
+ * chunk bytes, like a traversal that reads one node prefix at a time,
+ * and requires both to agree after every chunk
+ **/
+void RequireAgreement(cas::PathMatcher& interpreter, cas::PathMatcher& compiled,
+    const std::vector<uint8_t>& path, const cas::BinaryQP& query_path,
+    size_t chunk) {
+  cas::PathMatcher::State si;
+  cas::PathMatcher::State sc;
+  size_t len = 0;
+  cas::PathMatcher::PrefixMatch ri = cas::PathMatcher::INCOMPLETE;
+  cas::PathMatcher::PrefixMatch rc = cas::PathMatcher::INCOMPLETE;
+  while (ri == cas::PathMatcher::INCOMPLETE && len < path.size()) {
+    len = std::min(len + chunk, path.size());
+    ri = interpreter.MatchPathIncremental(path, query_path, len, si);
+    rc = compiled.MatchPathIncremental(path, query_path, len, sc);
+    REQUIRE(ri == rc);
+    if (ri == cas::PathMatcher::INCOMPLETE) {
+      bool any = interpreter.MatchesAnyNextByte(query_path, si);
+      REQUIRE(compiled.MatchesAnyNextByte(query_path, sc) == any);
+      if (!any) {
+        REQUIRE(compiled.NextByte(query_path, sc) ==
+            interpreter.NextByte(query_path, si));
+      }
+    }
+  }
+  REQUIRE(ri != cas::PathMatcher::INCOMPLETE);
+}
+
+} // namespace
+
+
+TEST_CASE("Compiled query paths match like the interpreter", "[cas::PathMatcher]") {
+  std::vector<std::string> inputs = {
+    "/", "/a", "/a/b", "/a/b/c", "/ab/abc", "/abc", "/abcd", "/abcde",
+    "/ab/aa/ab/cc/abd", "/ab/cd/x/a/b", "/ab/aa/ab/cc/ac", "/ab/aa/abc",
+    "/ab/abd/cc/de/abd", "/foo/bar/baz/abcde", "/foo/bar/baz/abcd",
+  };
+  std::vector<std::string> patterns = {
+    "^", "^^", "/ab/aa/ab/cc/abd", "/ab/?/x/a/b", "/?/?/?/?/?", "^ab/?/x^",
+    "/?/?^?/?", "/?/?/?/?", "^ab^abd", "/ab^cc/abd", "^ab^abd^",
+    "^ab/aa^cc/abd", "^abc", "^ab/abd^", "^abd^^^", "/ab^?", "^abcd",
+    "/ab/?/ab^ac", "/a^", "/?",
+  };
+  cas::Surrogate surrogate(7, 2);
+  cas::KeyEncoder<cas::vint64_t> encoder;
+  for (const auto& pattern : patterns) {
+    cas::SearchKey<cas::vint64_t> skey;
+    skey.path_ = { pattern };
+    cas::BinarySK bskey = encoder.Encode(skey);
+    cas::BinarySK sskey = encoder.Encode(skey, surrogate);
+    cas::PathMatcher interpreter;
+    cas::PathMatcher compiled;
+    compiled.Compile(bskey.path_);
+    cas::SurrogatePathMatcher surrogate_interpreter(surrogate);
+    cas::SurrogatePathMatcher surrogate_compiled(surrogate);
+    surrogate_compiled.Compile(sskey.path_);
+    for (const auto& input : inputs) {
+      INFO("input " << input << ", pattern " << pattern);
+      cas::Key<cas::vint64_t> key = ParsePath(input);
+      cas::BinaryKey bikey = encoder.Encode(key);
+      cas::BinaryKey sikey = encoder.Encode(key, surrogate);
+      REQUIRE(compiled.MatchPath(bikey.path_, bskey.path_) ==
+          interpreter.MatchPath(bikey.path_, bskey.path_));
+      REQUIRE(surrogate_compiled.MatchPath(sikey.path_, sskey.path_) ==
+          surrogate_interpreter.MatchPath(sikey.path_, sskey.path_));
+      for (size_t chunk : { 1, 2, 3, 5 }) {
+        RequireAgreement(interpreter, compiled, bikey.path_, bskey.path_, chunk);
+        RequireAgreement(surrogate_interpreter, surrogate_compiled,
+            sikey.path_, sskey.path_, chunk);
+      }
+    }
+  }
+}
+
+
+TEST_CASE("Paths that were not compiled are interpreted", "[cas::PathMatcher]") {
+  cas::KeyEncoder<cas::vint64_t> encoder;
+  cas::PathMatcher compiled;
+  cas::PathMatcher interpreter;
+  {
+    cas::SearchKey<cas::vint64_t> skey;
+    skey.path_ = { "/ab/?/x/a/b" };
+    cas::BinarySK bskey = encoder.Encode(skey);
+    compiled.Compile(bskey.path_);
+  }
+  // the compiled path is gone; the matcher is reused without Compile
+  for (const std::string pattern : { "^abc", "/ab^cc/abd", "/?" }) {
+    cas::SearchKey<cas::vint64_t> skey;
+    skey.path_ = { pattern };
+    cas::BinarySK bskey = encoder.Encode(skey);
+    for (const std::string input : { "/abc", "/ab/cd/x/a/b", "/ab/aa/ab/cc/abd" }) {
+      INFO("input " << input << ", pattern " << pattern);
+      cas::BinaryKey bikey = encoder.Encode(ParsePath(input));
+      REQUIRE(compiled.MatchPath(bikey.path_, bskey.path_) ==
+          interpreter.MatchPath(bikey.path_, bskey.path_));
+      for (size_t chunk : { 1, 3 }) {
+        RequireAgreement(interpreter, compiled, bikey.path_, bskey.path_, chunk);
+      }
+    }
+  }
+}
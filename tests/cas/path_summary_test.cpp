@@ -0,0 +1,114 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "cas/key_encoder.hpp"
+#include "cas/path_summary.hpp"
+#include "query_fixture.hpp"
+#include <deque>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+namespace {
+
+using VType = cas::vint64_t;
+
+const KeyGenerator kFiles("usr", { { "d", 13 }, { "f", 7 } });
+
+std::vector<uint8_t> Encode(std::vector<std::string> path) {
+  cas::Key<VType> key;
+  key.path_ = path;
+  key.value_ = 0;
+  cas::KeyEncoder<VType> encoder;
+  return encoder.Encode(key).path_;
+}
+
+} // namespace
+
+
+TEST_CASE("Path summaries count the keys of every path", "[cas::PathSummary]") {
+  cas::PathSummary summary;
+  summary.Add(Encode({ "usr", "lib" }));
+  summary.Add(Encode({ "usr", "lib" }), 2);
+  summary.Add(Encode({ "usr" }));
+  summary.Add(Encode({ "etc", "hosts" }));
+  REQUIRE(summary.NrPaths() == 3);
+  REQUIRE(summary.NrKeys() == 5);
+  REQUIRE(summary.NrKeys(Encode({ "usr", "lib" })) == 3);
+  REQUIRE(summary.NrKeys(Encode({ "usr", "li" })) == 0);
+
+  summary.Remove(Encode({ "usr", "lib" }), 3);
+  summary.Remove(Encode({ "var" }));
+  REQUIRE(summary.NrPaths() == 2);
+  REQUIRE(summary.NrKeys() == 2);
+  REQUIRE(summary.NrKeys(Encode({ "usr", "lib" })) == 0);
+  REQUIRE(summary.NrKeys(Encode({ "usr" })) == 1);
+
+  cas::KeyEncoder<VType> encoder;
+  auto skey = MakeQuery<VType>("/?/hosts", 0, 0);
+  cas::BinarySK bkey = encoder.Encode(skey);
+  cas::PathMatcher pm;
+  pm.Compile(bkey.path_);
+  std::vector<cas::PathSummary::Path> paths;
+  REQUIRE(summary.Resolve(bkey.path_, pm, 10, paths));
+  REQUIRE(paths.size() == 1);
+  REQUIRE(paths[0].nr_keys_ == 1);
+  std::vector<uint8_t> expected = Encode({ "etc", "hosts" });
+  expected.pop_back(); // kNullByte
+  REQUIRE(paths[0].query_path_.bytes_ == expected);
+}
+
+
+TEST_CASE("Queries resolved against the path summary", "[cas::PathSummary]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  index.EnablePathSummary();
+  // every query with matches is executed as exact-path probes
+  index.max_path_probes_ = 1000;
+  std::vector<cas::Key<VType>> keys;
+  for (int i = 0; i < 3300; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 10000));
+    if (i % 10 == 0) {
+      keys.back().path_.push_back("Makefile");
+    }
+  }
+  std::deque<cas::Key<VType>> loaded(keys.begin(), keys.begin() + 3000);
+  index.BulkLoad(loaded);
+  for (size_t i = 3000; i < keys.size(); ++i) {
+    index.Insert(keys[i], cas::UpdateType::LazyFast, cas::UpdateType::LazyFast,
+        cas::InsertTarget::AuxiliaryOnly);
+  }
+  for (size_t i = 0; i < keys.size(); i += 3) {
+    index.Delete(keys[i]);
+  }
+  // 13*7 paths without and 13*7 paths with a Makefile
+  REQUIRE(index.path_summary_->NrPaths() == 182);
+  REQUIRE(index.path_summary_->NrKeys() == 2200);
+  // a rejected insert leaves the summary as it is
+  REQUIRE_THROWS(index.Insert(keys[1], cas::UpdateType::LazyFast,
+        cas::UpdateType::LazyFast, static_cast<cas::InsertTarget>(-1)));
+  REQUIRE(index.path_summary_->NrKeys() == 2200);
+
+  std::vector<cas::SearchKey<VType>> queries = {
+    MakeQuery<VType>("/usr/d3^Makefile", cas::VINT64_MIN, cas::VINT64_MAX),
+    MakeQuery<VType>("/usr/?/f2", 2000, 8000),
+    MakeQuery<VType>("/usr^", 0, 5000),
+    MakeQuery<VType>("/usr/d1/f1", cas::VINT64_MIN, cas::VINT64_MAX),
+    MakeQuery<VType>("/etc^", cas::VINT64_MIN, cas::VINT64_MAX),
+    MakeQuery<VType>("/usr/?/f9", cas::VINT64_MIN, cas::VINT64_MAX),
+  };
+  for (auto& skey : queries) {
+    std::multiset<Match<VType>> resolved = Matches(index, skey);
+    cas::QueryStats stats = index.QueryRuntime(skey);
+    index.DisablePathSummary();
+    std::multiset<Match<VType>> expected = Matches(index, skey);
+    cas::QueryStats full = index.QueryRuntime(skey);
+    index.EnablePathSummary();
+    REQUIRE(resolved == expected);
+    REQUIRE(stats.nr_matches_ == full.nr_matches_);
+    if (expected.empty()) {
+      // rejected without a traversal
+      REQUIRE(stats.read_path_nodes_ + stats.read_value_nodes_ == 0);
+    }
+  }
+}
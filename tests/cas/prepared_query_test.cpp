@@ -0,0 +1,107 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "cas/prepared_query.hpp"
+#include "query_fixture.hpp"
+#include <deque>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+
+namespace {
+
+using VType = cas::vint64_t;
+
+const KeyGenerator kFiles("usr", { { "d", 13 }, { "f", 101 } });
+
+std::multiset<Match<VType>> Matches(cas::Cas<VType>& index,
+    const cas::PreparedQuery<VType>& prepared, VType low, VType high) {
+  std::multiset<Match<VType>> matches;
+  index.Query(prepared, low, high, [&](const cas::Key<VType>& key) {
+    matches.insert(Match<VType>(key.path_, key.value_, key.did_));
+  });
+  return matches;
+}
+
+} // namespace
+
+
+TEST_CASE("Prepared queries match ad-hoc queries", "[cas::PreparedQuery]") {
+  std::unique_ptr<cas::Cas<VType>> indexes[] = {
+    std::unique_ptr<cas::Cas<VType>>(
+        new cas::Cas<VType>(cas::IndexType::TwoDimensional, {})),
+    std::unique_ptr<cas::Cas<VType>>(
+        new cas::Cas<VType>(cas::IndexType::TwoDimensional, {}, 5, 2)),
+  };
+  std::vector<std::vector<std::string>> paths = {
+    { "/usr/d3^" },
+    { "/usr/?/f7" },
+    { "/usr/d1/f14" },
+    { "/etc^" },
+  };
+  std::vector<std::pair<VType, VType>> bounds = {
+    { cas::VINT64_MIN, cas::VINT64_MAX },
+    { 2000, 4000 },
+    { 5000, 5000 },
+    { 9000, 100 },
+  };
+  for (auto& index : indexes) {
+    std::deque<cas::Key<VType>> keys;
+    for (int i = 0; i < 3000; ++i) {
+      keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 10000));
+    }
+    index->BulkLoad(keys);
+    for (const auto& path : paths) {
+      auto prepared = index->Prepare(path);
+      for (const auto& bound : bounds) {
+        std::multiset<Match<VType>> expected = Matches(*index,
+            MakeQuery<VType>(path[0], bound.first, bound.second));
+        REQUIRE(Matches(*index, *prepared, bound.first, bound.second) == expected);
+      }
+    }
+  }
+}
+
+
+TEST_CASE("Threads can execute a prepared query at once", "[cas::PreparedQuery]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 3000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 10000));
+  }
+  index.BulkLoad(keys);
+  for (int i = 3000; i < 3500; ++i) {
+    auto key = kFiles.Key<VType>(i, (i * 7919) % 10000);
+    index.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast,
+        cas::InsertTarget::AuxiliaryOnly);
+  }
+
+  std::vector<std::string> path = { "/usr/?/f1^" };
+  auto prepared = index.Prepare(path);
+  const size_t nr_threads = 4;
+  std::vector<std::multiset<Match<VType>>> expected;
+  for (size_t t = 0; t < nr_threads; ++t) {
+    expected.push_back(Matches(index,
+          MakeQuery<VType>(path[0], 1000 * t, 1000 * t + 2500)));
+  }
+
+  std::vector<std::multiset<Match<VType>>> matches(nr_threads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < nr_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 20; ++i) {
+        matches[t] = Matches(index, *prepared, 1000 * t, 1000 * t + 2500);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 0; t < nr_threads; ++t) {
+    REQUIRE(!expected[t].empty());
+    REQUIRE(matches[t] == expected[t]);
+  }
+}
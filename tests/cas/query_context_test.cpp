@@ -0,0 +1,69 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "cas/query_context.hpp"
+#include "query_fixture.hpp"
+#include <deque>
+#include <set>
+#include <string>
+
+
+namespace {
+
+using VType = cas::vint64_t;
+
+void Load(cas::Cas<VType>& index) {
+  std::deque<cas::Key<VType>> keys = {
+    MakeKey<VType>({ "usr", "include", "stdio.h" }, 10, 1),
+    MakeKey<VType>({ "usr", "lib" }, 20, 2),
+    MakeKey<VType>({ "opt", "lib" }, 30, 3),
+    MakeKey<VType>({ "usr", "lib", "libc.so" }, 40, 4),
+  };
+  index.BulkLoad(keys);
+}
+
+} // namespace
+
+
+TEST_CASE("Reused query contexts give the results of fresh ones", "[cas::QueryContext]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  Load(index);
+
+  // a long query leaves bytes behind in the context of this thread
+  REQUIRE(Dids(index, MakeQuery<VType>("/usr/include/stdio.h", 0, 100)) ==
+      std::set<cas::did_t>({ 1 }));
+  REQUIRE(Dids(index, MakeQuery<VType>("/?/lib", 0, 100)) ==
+      std::set<cas::did_t>({ 2, 3 }));
+  REQUIRE(Dids(index, MakeQuery<VType>("/usr^", 15, 100)) ==
+      std::set<cas::did_t>({ 2, 4 }));
+
+  cas::QueryContext context;
+  std::set<cas::did_t> dids;
+  auto skey = MakeQuery<VType>("/?/lib", 0, 100);
+  for (int i = 0; i < 3; ++i) {
+    dids.clear();
+    index.Query(skey, [&](const std::vector<uint8_t>&,
+          const std::vector<uint8_t>&, cas::did_t did) {
+      dids.insert(did);
+    }, context);
+    REQUIRE(dids == std::set<cas::did_t>({ 2, 3 }));
+  }
+  REQUIRE(!context.in_use_);
+}
+
+
+TEST_CASE("Emitters can issue nested queries", "[cas::QueryContext]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  Load(index);
+
+  std::set<cas::did_t> outer;
+  std::set<cas::did_t> inner;
+  auto skey = MakeQuery<VType>("/usr^", 0, 100);
+  index.Query(skey, [&](const cas::Key<VType>& key) {
+    outer.insert(key.did_);
+    inner = Dids(index, MakeQuery<VType>("/opt/lib", 0, 100));
+  });
+  REQUIRE(outer == std::set<cas::did_t>({ 1, 2, 4 }));
+  REQUIRE(inner == std::set<cas::did_t>({ 3 }));
+  REQUIRE(!cas::QueryContext::ForThisThread().in_use_);
+}
+
@@ -0,0 +1,128 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "query_fixture.hpp"
+#include <deque>
+#include <string>
+
+
+namespace {
+
+const KeyGenerator kFiles("usr", { { "d", 7 }, { "f", 50 } });
+
+} // namespace
+
+
+TEST_CASE("Count agrees with the enumerated matches", "[cas::Count]") {
+  using VType = cas::vint64_t;
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 2000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 10000));
+  }
+  index.BulkLoad(keys);
+  for (int i = 2000; i < 2100; ++i) {
+    auto key = kFiles.Key<VType>(i, (i * 7919) % 10000);
+    index.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast,
+        cas::InsertTarget::AuxiliaryOnly);
+  }
+  for (int i = 0; i < 300; ++i) {
+    REQUIRE(index.Delete(kFiles.Key<VType>(i, (i * 7919) % 10000)));
+  }
+
+  auto all = MakeQuery<VType>("^", cas::VINT64_MIN, cas::VINT64_MAX);
+  REQUIRE(index.Count(all) == 1800);
+
+  std::vector<cas::SearchKey<VType>> queries = {
+    MakeQuery<VType>("/usr^", 5000, cas::VINT64_MAX),
+    MakeQuery<VType>("/usr/d3^", cas::VINT64_MIN, 2500),
+    MakeQuery<VType>("/usr/?/f7", 0, 10000),
+    MakeQuery<VType>("^/f12", 1000, 9000),
+    MakeQuery<VType>("/usr/d1/f1", 0, 0),
+    MakeQuery<VType>("/etc^", cas::VINT64_MIN, cas::VINT64_MAX),
+  };
+  for (auto& skey : queries) {
+    REQUIRE(index.Count(skey) == Matches(index, skey).size());
+  }
+}
+
+
+TEST_CASE("Count drops every copy of a deleted DID", "[cas::Count]") {
+  using VType = cas::vint64_t;
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 200; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 10000));
+  }
+  index.BulkLoad(keys);
+  auto key = kFiles.Key<VType>(42, (42 * 7919) % 10000);
+  index.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast,
+      cas::InsertTarget::MainOnly);
+  REQUIRE(index.Delete(key));
+
+  auto skey = MakeQuery<VType>("/usr^", cas::VINT64_MIN, cas::VINT64_MAX);
+  REQUIRE(Matches(index, skey).size() == 199);
+  REQUIRE(index.Count(skey) == 199);
+  cas::CardinalityEstimate estimate = index.Estimate(skey, 0, 1);
+  REQUIRE(estimate.IsExact());
+  REQUIRE(estimate.lower_ == 199);
+}
+
+
+TEST_CASE("Count handles string values", "[cas::Count]") {
+  using VType = cas::vstring_t;
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 500; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, "v" + std::to_string(i % 37)));
+  }
+  index.BulkLoad(keys);
+
+  std::vector<cas::SearchKey<VType>> queries = {
+    MakeQuery<VType>("^", "", "\xFF"),
+    MakeQuery<VType>("/usr^", "v1", "v2"),
+    MakeQuery<VType>("/usr/d2^", "v", "v3"),
+    MakeQuery<VType>("/usr/?/f4", "v10", "v10"),
+  };
+  REQUIRE(index.Count(queries[0]) == 500);
+  for (auto& skey : queries) {
+    REQUIRE(index.Count(skey) == Matches(index, skey).size());
+  }
+}
+
+
+TEST_CASE("Estimates bound the exact count", "[cas::Estimate]") {
+  using VType = cas::vint64_t;
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 5000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, (i * 7919) % 10000));
+  }
+  index.BulkLoad(keys);
+
+  std::vector<cas::SearchKey<VType>> queries = {
+    MakeQuery<VType>("^", cas::VINT64_MIN, cas::VINT64_MAX),
+    MakeQuery<VType>("/usr^", 5000, cas::VINT64_MAX),
+    MakeQuery<VType>("/usr/d3^", cas::VINT64_MIN, 2500),
+    MakeQuery<VType>("/usr/?/f7", 0, 10000),
+    MakeQuery<VType>("/etc^", cas::VINT64_MIN, cas::VINT64_MAX),
+  };
+  for (auto& skey : queries) {
+    uint64_t exact = index.Count(skey);
+    for (size_t max_depth : { 0, 1, 2, 4 }) {
+      cas::CardinalityEstimate estimate = index.Estimate(skey, max_depth, 32);
+      REQUIRE(estimate.lower_ <= exact);
+      REQUIRE(estimate.upper_ >= exact);
+      REQUIRE(estimate.estimate_ >= estimate.lower_);
+      REQUIRE(estimate.estimate_ <= estimate.upper_);
+    }
+    cas::CardinalityEstimate estimate = index.Estimate(skey, 100, 1000000);
+    REQUIRE(estimate.IsExact());
+    REQUIRE(estimate.lower_ == exact);
+  }
+
+  // the whole index is contained in the query at the root
+  cas::CardinalityEstimate all = index.Estimate(queries[0], 0, 1);
+  REQUIRE(all.IsExact());
+  REQUIRE(all.lower_ == 5000);
+  REQUIRE(all.read_nodes_ == 1);
+}
@@ -0,0 +1,90 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "cas/query_cursor.hpp"
+#include "query_fixture.hpp"
+#include <deque>
+#include <set>
+#include <string>
+
+
+namespace {
+
+using VType = cas::vint64_t;
+
+const KeyGenerator kFiles("usr", { { "d", 10 }, { "f", 100 } });
+
+// 1000 keys in the main index and 20 keys in the auxiliary index
+void Load(cas::Cas<VType>& index) {
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 1000; ++i) {
+    keys.push_back(kFiles.Key<VType>(i, i * 1009));
+  }
+  index.BulkLoad(keys);
+  for (int i = 1000; i < 1020; ++i) {
+    auto key = kFiles.Key<VType>(i, i * 1009);
+    index.Insert(key, cas::UpdateType::LazyFast, cas::UpdateType::LazyFast,
+        cas::InsertTarget::AuxiliaryOnly);
+  }
+}
+
+} // namespace
+
+
+TEST_CASE("Cursors yield the matches of the main and auxiliary index", "[cas::QueryCursor]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  Load(index);
+  REQUIRE(index.getAuxiliaryIndex() != nullptr);
+
+  auto skey = MakeQuery<VType>("/usr/d3/?", 0, 1010 * 1009);
+  std::set<cas::did_t> expected;
+  index.Query(skey, [&](const cas::Key<VType>& key) {
+    expected.insert(key.did_);
+  });
+  REQUIRE(expected.size() == 101);
+
+  auto cursor = index.Cursor(skey);
+  std::set<cas::did_t> dids;
+  while (cursor->Next()) {
+    cas::Key<VType> key = cursor->Current();
+    REQUIRE(key.did_ == cursor->Did());
+    REQUIRE(key.value_ == static_cast<VType>(key.did_ * 1009));
+    dids.insert(cursor->Did());
+  }
+  REQUIRE(dids == expected);
+  REQUIRE(cursor->Stats().nr_matches_ == 101);
+  REQUIRE(!cursor->Next());
+}
+
+
+TEST_CASE("Cursor limits stop the traversal early", "[cas::QueryCursor]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  Load(index);
+
+  auto skey = MakeQuery<VType>("/usr^", cas::VINT64_MIN, cas::VINT64_MAX);
+  cas::QueryStats full = index.QueryRuntime(skey);
+
+  auto cursor = index.Cursor(skey);
+  std::set<cas::did_t> dids;
+  cursor->Limit(5);
+  while (cursor->Next()) {
+    dids.insert(cursor->Did());
+  }
+  REQUIRE(dids.size() == 5);
+  cas::QueryStats page = cursor->Stats();
+  REQUIRE(page.nr_matches_ == 5);
+  REQUIRE(page.read_path_nodes_ + page.read_value_nodes_ <
+      full.read_path_nodes_ + full.read_value_nodes_);
+
+  // the next page continues where the first one stopped
+  cursor->Limit(5);
+  while (cursor->Next()) {
+    dids.insert(cursor->Did());
+  }
+  REQUIRE(dids.size() == 10);
+
+  cursor->Limit(10000);
+  while (cursor->Next()) {
+    dids.insert(cursor->Did());
+  }
+  REQUIRE(dids.size() == 1020);
+}
@@ -0,0 +1,41 @@
+#include "test/catch.hpp"
+#include "cas/cas.hpp"
+#include "query_fixture.hpp"
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+using VType = cas::vint64_t;
+
+} // namespace
+
+
+TEST_CASE("The prefetch distance does not change query results", "[cas::Query]") {
+  cas::Cas<VType> index(cas::IndexType::TwoDimensional, {});
+  std::deque<cas::Key<VType>> keys;
+  for (int i = 0; i < 500; ++i) {
+    // long labels spill the prefixes of some nodes to the heap
+    keys.push_back(MakeKey<VType>({ "usr", "share-" + std::to_string(i % 7) +
+          "-with-a-long-directory-name", "f" + std::to_string(i) },
+          (i * 37) % 1000, i));
+  }
+  index.BulkLoad(keys);
+
+  std::vector<cas::SearchKey<VType>> queries = {
+    MakeQuery<VType>("/usr^", 0, 1000),
+    MakeQuery<VType>("/usr/?/f1^", 100, 600),
+    MakeQuery<VType>("^", 250, 250),
+  };
+  for (auto& skey : queries) {
+    index.prefetch_distance_ = 0;
+    std::set<cas::did_t> expected = Dids(index, skey);
+    for (size_t distance : { 1, 4, 64 }) {
+      index.prefetch_distance_ = distance;
+      REQUIRE(Dids(index, skey) == expected);
+    }
+  }
+}
@@ -0,0 +1,98 @@
+#ifndef CAS_TEST_QUERY_FIXTURE_H_
+#define CAS_TEST_QUERY_FIXTURE_H_
+
+#include "cas/cas.hpp"
+#include "cas/key.hpp"
+#include "cas/search_key.hpp"
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+// keys, queries and result collectors shared by the query tests
+
+
+template<class VType>
+using Match = std::tuple<std::vector<std::string>, VType, cas::did_t>;
+
+
+template<class VType>
+cas::Key<VType> MakeKey(std::vector<std::string> path, VType value, cas::did_t did) {
+  cas::Key<VType> key;
+  key.path_ = path;
+  key.value_ = value;
+  key.did_ = did;
+  return key;
+}
+
+
+template<class VType>
+cas::SearchKey<VType> MakeQuery(std::string path, VType low, VType high) {
+  cas::SearchKey<VType> skey;
+  skey.path_ = { path };
+  skey.low_  = low;
+  skey.high_ = high;
+  return skey;
+}
+
+
+/**
+ * Generates the keys of a synthetic file system. Key i has DID i and
+ * the path root/<label><i % fan-out>/... with one label per level,
+ * e.g. { "usr", "d3", "f17" } for the levels { "d", 7 }, { "f", 50 }.
+ **/
+class KeyGenerator {
+  std::string root_;
+  std::vector<std::pair<std::string, int>> levels_;
+
+public:
+  KeyGenerator(std::string root,
+      std::vector<std::pair<std::string, int>> levels)
+    : root_(root)
+    , levels_(levels)
+  {}
+
+  std::vector<std::string> Path(int i) const {
+    std::vector<std::string> path = { root_ };
+    for (const auto& level : levels_) {
+      path.push_back(level.first + std::to_string(i % level.second));
+    }
+    return path;
+  }
+
+  template<class VType>
+  cas::Key<VType> Key(int i, VType value) const {
+    return MakeKey<VType>(Path(i), value, i);
+  }
+};
+
+
+/**
+ * All matches of a query, decoded
+ **/
+template<class VType>
+std::multiset<Match<VType>> Matches(cas::Cas<VType>& index,
+    cas::SearchKey<VType> skey) {
+  std::multiset<Match<VType>> matches;
+  index.Query(skey, [&](const cas::Key<VType>& key) {
+    matches.insert(Match<VType>(key.path_, key.value_, key.did_));
+  });
+  return matches;
+}
+
+
+/**
+ * The distinct DIDs of the matches of a query
+ **/
+template<class VType>
+std::set<cas::did_t> Dids(cas::Cas<VType>& index, cas::SearchKey<VType> skey) {
+  std::set<cas::did_t> dids;
+  index.Query(skey, [&](cas::did_t did) {
+    dids.insert(did);
+  });
+  return dids;
+}
+
+#endif // CAS_TEST_QUERY_FIXTURE_H_